@@ -0,0 +1,117 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Style/StyleParser.h>
+#include <toyui/Context/Glfw/GlfwContext.h>
+
+#include <cstring>
+
+#ifndef TOYUI_RESOURCE_PATH
+	#define TOYUI_RESOURCE_PATH "../../data/"
+#endif
+
+namespace toy
+{
+	std::vector<BenchmarkCase>& benchmarkCases()
+	{
+		static std::vector<BenchmarkCase> cases;
+		return cases;
+	}
+
+	Window& createDeepTree(Container& parent, size_t depth, Container*& deepest)
+	{
+		Window& window = parent.emplace<Window>("Deep Tree");
+		deepest = &window.emplace<Container>();
+		for(size_t i = 0; i < depth; ++i)
+		{
+			deepest->emplace<Label>("Depth " + std::to_string(i));
+			deepest = &deepest->emplace<Container>();
+		}
+		return window;
+	}
+
+	Window& createWideTree(Container& parent, size_t items, Container*& list)
+	{
+		Window& window = parent.emplace<Window>("Wide Tree");
+		list = &window.emplace<Container>();
+		for(size_t i = 0; i < items; ++i)
+			list->emplace<Label>("Item " + std::to_string(i));
+		return window;
+	}
+
+	void createLayeredTree(Container& parent, size_t layers, size_t items)
+	{
+		for(size_t w = 0; w < layers; ++w)
+		{
+			Window& window = parent.emplace<Window>("Layer " + std::to_string(w));
+			for(size_t i = 0; i < items; ++i)
+				window.emplace<Label>("Item " + std::to_string(i));
+		}
+	}
+
+	std::vector<float> collectGeometry(MasterLayer& layer)
+	{
+		std::vector<float> geometry;
+		layer.visit([&geometry](Frame& frame) { geometry.insert(geometry.end(), { frame.left(), frame.top(), frame.width(), frame.height() }); return true; });
+		return geometry;
+	}
+
+	const char* checkGeometry(const std::vector<float>& geometry, const std::vector<float>& reference, bool& passed)
+	{
+		bool identical = geometry == reference;
+		passed &= identical;
+		return identical ? "identical" : "MISMATCH";
+	}
+}
+
+using namespace toy;
+
+// runs the cases named on the command line, or all of them, each in a sheet of its own
+int main(int argc, char *argv[])
+{
+	if(argc > 1 && strcmp(argv[1], "--list") == 0)
+	{
+		for(BenchmarkCase& benchmark : benchmarkCases())
+			printf("%s\n", benchmark.name);
+		return 0;
+	}
+
+	GlfwRenderSystem renderSystem(TOYUI_RESOURCE_PATH);
+	UiWindow uiwindow(renderSystem, "toyui benchmark", 1200, 800, false);
+	RootSheet& rootSheet = uiwindow.rootSheet();
+
+	// the render cases draw the skins of an actual theme
+	StyleParser parser(uiwindow.styler());
+	parser.loadStyleSheet(uiwindow.resourcePath() + "interface/styles/blendish_dark.yml");
+
+	size_t ran = 0;
+	size_t failed = 0;
+	for(BenchmarkCase& benchmark : benchmarkCases())
+	{
+		bool selected = argc == 1;
+		for(int i = 1; i < argc; ++i)
+			selected |= strcmp(argv[i], benchmark.name) == 0;
+		if(!selected)
+			continue;
+
+		Container& sheet = rootSheet.emplace<Container>(Board::cls());
+		rootSheet.frame().as<MasterLayer>().relayout();
+
+		bool passed = benchmark.func(sheet);
+		printf("INFO: benchmark %s %s\n", benchmark.name, passed ? "passed" : "FAILED");
+
+		rootSheet.release(sheet);
+		++ran;
+		failed += passed ? 0 : 1;
+	}
+
+	if(ran == 0)
+	{
+		printf("ERROR: no benchmark matches, run with --list to see them\n");
+		return 1;
+	}
+
+	return failed > 0 ? 1 : 0;
+}
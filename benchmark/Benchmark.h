@@ -0,0 +1,61 @@
+
+#ifndef TOY_BENCHMARK_H
+#define TOY_BENCHMARK_H
+
+#include <toyui/Config.h>
+#include <toyui/Forward.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace toy
+{
+	// accumulates the time spent between each start and stop, in milliseconds
+	class Stopwatch
+	{
+	public:
+		void start() { m_start = std::chrono::high_resolution_clock::now(); }
+		double stop() { double lap = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_start).count(); m_total += lap; return lap; }
+
+		template <class T_Function>
+		double time(T_Function func) { this->start(); func(); return this->stop(); }
+
+		double total() const { return m_total; }
+
+	protected:
+		std::chrono::high_resolution_clock::time_point m_start;
+		double m_total = 0.0;
+	};
+
+	// a case builds its own widgets in the sheet it is given, reports its results and returns false when they don't check out
+	using BenchmarkFunc = std::function<bool(Container& sheet)>;
+
+	struct BenchmarkCase
+	{
+		const char* name;
+		BenchmarkFunc func;
+	};
+
+	std::vector<BenchmarkCase>& benchmarkCases();
+
+	struct BenchmarkRegistrar
+	{
+		BenchmarkRegistrar(const char* name, BenchmarkFunc func) { benchmarkCases().push_back({ name, func }); }
+	};
+
+#define TOY_BENCHMARK(name) \
+	static bool benchmark##name(Container& sheet); \
+	static BenchmarkRegistrar registrar##name(#name, &benchmark##name); \
+	static bool benchmark##name(Container& sheet)
+
+	// fixtures shared by the cases
+	Window& createDeepTree(Container& parent, size_t depth, Container*& deepest);
+	Window& createWideTree(Container& parent, size_t items, Container*& list);
+	void createLayeredTree(Container& parent, size_t layers, size_t items);
+
+	std::vector<float> collectGeometry(MasterLayer& layer);
+	const char* checkGeometry(const std::vector<float>& geometry, const std::vector<float>& reference, bool& passed);
+}
+
+#endif
@@ -0,0 +1,48 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Render/Renderer.h>
+
+namespace toy
+{
+	// while scrolling a long list, only the items within the clip of the panel are gone through by the render traversal
+	TOY_BENCHMARK(Culling)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		MasterLayer& layer = rootSheet.frame().as<MasterLayer>();
+		Renderer& renderer = rootSheet.uiWindow().renderer();
+		const size_t count = 120;
+		const size_t items = 10000;
+
+		Window& window = sheet.emplace<Window>("Culling");
+		ScrollSheet& panel = window.emplace<ScrollSheet>();
+		for(size_t i = 0; i < items; ++i)
+			panel.emplace<Label>("Item " + std::to_string(i));
+
+		Frame& container = panel.container().frame();
+		layer.relayout();
+		layer.redraw();
+		rootSheet.target().render();
+
+		size_t visited = 0;
+		size_t drawn = 0;
+		Stopwatch stopwatch;
+		for(size_t i = 0; i < count; ++i)
+		{
+			stopwatch.start();
+			container.setPositionDim(DIM_Y, -float(i % 60) * 4.f);
+			layer.relayout();
+			layer.redraw();
+			rootSheet.target().render();
+			stopwatch.stop();
+			visited += renderer.visitedFrames();
+			drawn += renderer.drawnFrames();
+		}
+
+		printf("INFO: culling benchmark, %zu items panel : %.1f frames visited, %.1f drawn, %.3f us per frame\n",
+			   items, double(visited) / count, double(drawn) / count, stopwatch.total() * 1000.0 / count);
+		return visited / count < items;
+	}
+}
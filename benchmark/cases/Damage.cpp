@@ -0,0 +1,75 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Render/Renderer.h>
+
+namespace toy
+{
+	// a blinking label damages its own area only, and a frame where nothing changed damages nothing
+	// a partial redraw repaints the damage of as many frames as the back buffer is old, and everything when its age is unknown
+	TOY_BENCHMARK(Damage)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const size_t count = 1000;
+
+		Window& window = sheet.emplace<Window>("Damage");
+		Label& first = window.emplace<Label>("Item 0");
+		for(size_t i = 1; i < 100; ++i)
+			window.emplace<Label>("Item " + std::to_string(i));
+		Label& label = window.emplace<Label>("Status : idle");
+
+		layer.relayout();
+		layer.redraw();
+		layer.clearDamage();
+
+		double area = 0.0;
+		size_t frames = 0;
+		Stopwatch stopwatch;
+		for(size_t i = 0; i < count; ++i)
+		{
+			stopwatch.time([&] {
+				label.setLabel(i % 2 ? "Status : idle" : "Status : busy");
+				layer.relayout();
+				layer.redraw();
+			});
+			area += layer.damage().w() * layer.damage().h();
+			frames += layer.damagedFrames();
+			layer.clearDamage();
+		}
+
+		layer.relayout();
+		layer.redraw();
+		bool idle = !layer.damaged();
+
+		double full = double(layer.width()) * double(layer.height());
+		printf("INFO: damage benchmark, blinking label : %.3f%% of the window damaged, %.1f frames damaged per update, %.3f us per update, idle frame %s\n",
+			   full > 0.0 ? area / count / full * 100.0 : 0.0, double(frames) / count, stopwatch.total() * 1000.0 / count, idle ? "skipped" : "damaged");
+
+		RenderTarget& target = sheet.rootSheet().target();
+		bool partialRedraw = target.partialRedraw();
+		target.setPartialRedraw(true);
+
+		auto redraw = [&](Label& changed, const string& text, size_t age) {
+			changed.setLabel(text);
+			layer.relayout();
+			layer.redraw();
+			target.setBufferAge(age);
+			target.render();
+			return target.redrawRect();
+		};
+
+		BoxFloat unknown = redraw(label, "Status : busy", 0);
+		BoxFloat single = redraw(first, "Item 0 : changed", 1);
+		BoxFloat twice = redraw(label, "Status : idle", 2);
+		target.setPartialRedraw(partialRedraw);
+		target.setBufferAge(0);
+
+		bool whole = unknown.w() == layer.width() && unknown.h() == layer.height();
+		bool covered = twice.y() <= single.y() && twice.y() + twice.h() >= single.y() + single.h() && twice.h() > single.h();
+		printf("INFO: damage benchmark, buffer age : unknown age %s, second frame %s\n", whole ? "redraws everything" : "PARTIAL", covered ? "covers the previous damage" : "MISSES THE PREVIOUS DAMAGE");
+
+		return idle && whole && covered;
+	}
+}
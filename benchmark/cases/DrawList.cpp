@@ -0,0 +1,47 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Render/Renderer.h>
+
+namespace toy
+{
+	// every frame is recorded again, the primitives of all the frames of a layer being sorted by state together before they reach the backend
+	TOY_BENCHMARK(DrawList)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		MasterLayer& layer = rootSheet.frame().as<MasterLayer>();
+		Renderer& renderer = rootSheet.uiWindow().renderer();
+		const size_t count = 20;
+
+		createLayeredTree(sheet, 8, 200);
+		layer.relayout();
+		layer.redraw();
+
+		size_t commands = 0;
+		size_t unsortedCalls = 0;
+		size_t unsortedChanges = 0;
+		size_t calls = 0;
+		size_t changes = 0;
+		Stopwatch stopwatch;
+		for(size_t i = 0; i < count; ++i)
+		{
+			layer.setForceRedraw();
+			for(Layer* sublayer : layer.layers())
+				sublayer->setForceRedraw();
+			layer.damageAll();
+
+			stopwatch.time([&] { rootSheet.target().render(); });
+			commands += renderer.drawCommands();
+			unsortedCalls += renderer.unsortedDrawCalls();
+			unsortedChanges += renderer.unsortedStateChanges();
+			calls += renderer.drawCalls();
+			changes += renderer.stateChanges();
+		}
+
+		printf("INFO: draw list benchmark, full redraw : %.1f commands, %.1f draw calls and %.1f state changes in emission order, %.1f draw calls and %.1f state changes sorted, %.3f us per render\n",
+			   double(commands) / count, double(unsortedCalls) / count, double(unsortedChanges) / count, double(calls) / count, double(changes) / count, stopwatch.total() * 1000.0 / count);
+		return calls <= unsortedCalls && changes <= unsortedChanges;
+	}
+}
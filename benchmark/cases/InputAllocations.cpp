@@ -0,0 +1,39 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Input/InputDevice.h>
+
+namespace toy
+{
+	// the first sweep over the layered tree sizes the hover buffers, the second one should not allocate anymore
+	TOY_BENCHMARK(InputAllocations)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		MasterLayer& layer = rootSheet.frame().as<MasterLayer>();
+		Mouse& mouse = rootSheet.mouse();
+		const size_t events = 10000;
+
+		createLayeredTree(sheet, 8, 2000);
+		layer.relayout();
+
+		auto sweep = [&](size_t count) {
+			for(size_t i = 0; i < count; ++i)
+				mouse.dispatchMouseMoved(float(i * 7919 % 1000) / 1000.f * layer.width(), float(i * 104729 % 1000) / 1000.f * layer.height());
+		};
+
+		size_t start = mouse.allocations();
+		sweep(events);
+		size_t warmup = mouse.allocations() - start;
+
+		start = mouse.allocations();
+		Stopwatch stopwatch;
+		stopwatch.time([&] { sweep(events); });
+		size_t steady = mouse.allocations() - start;
+
+		printf("INFO: input allocation benchmark, %zu moves : %zu allocations warming up, %.3f allocations per event in steady state, %.3f us per move\n", events,
+			   warmup, double(steady) / events, stopwatch.total() * 1000.0 / events);
+		return steady == 0;
+	}
+}
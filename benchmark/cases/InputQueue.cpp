@@ -0,0 +1,63 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Input/InputDispatcher.h>
+#include <toyui/Input/InputDevice.h>
+
+namespace toy
+{
+	class BenchmarkInputWindow : public InputWindow
+	{
+	public:
+		virtual bool nextFrame() { return true; }
+		virtual void initInput(Mouse& mouse, Keyboard& keyboard) { UNUSED(mouse); UNUSED(keyboard); }
+		virtual void resize(size_t width, size_t height) { UNUSED(width); UNUSED(height); }
+	};
+
+	// the same stream of events dispatched as they come, or queued and coalesced until the frame starts
+	TOY_BENCHMARK(InputQueue)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		const size_t frames = 1000;
+
+		createLayeredTree(sheet, 8, 2000);
+		rootSheet.frame().as<MasterLayer>().relayout();
+
+		Mouse& mouse = rootSheet.mouse();
+		Keyboard& keyboard = rootSheet.keyboard();
+
+		// a fast pointer sends several moves per frame, interleaved with a key stroke now and then
+		auto feed = [](size_t frame, const std::function<void(float, float)>& move, const std::function<void(bool)>& key) {
+			for(size_t i = 0; i < 16; ++i)
+				move(float((frame * 16 + i) % 800), float((frame * 16 + i) % 600));
+			key(true);
+			for(size_t i = 0; i < 16; ++i)
+				move(float((frame * 16 + i) % 800), float((frame * 16 + i + 8) % 600));
+			key(false);
+		};
+
+		Stopwatch direct;
+		direct.time([&] {
+			for(size_t frame = 0; frame < frames; ++frame)
+				feed(frame, [&](float x, float y) { mouse.dispatchMouseMoved(x, y); },
+							[&](bool down) { down ? keyboard.dispatchKeyPressed(KC_LSHIFT, 0) : keyboard.dispatchKeyReleased(KC_LSHIFT, 0); });
+		});
+
+		BenchmarkInputWindow input;
+		Stopwatch queued;
+		queued.time([&] {
+			for(size_t frame = 0; frame < frames; ++frame)
+			{
+				feed(frame, [&](float x, float y) { input.queueMouseMoved(x, y); },
+							[&](bool down) { down ? input.queueKeyPressed(KC_LSHIFT, 0) : input.queueKeyReleased(KC_LSHIFT, 0); });
+				input.dispatchEvents(mouse, keyboard);
+			}
+		});
+
+		printf("INFO: input queue benchmark, %zu frames : %zu events received, %zu dispatched, %.3f ms per frame dispatching directly, %.3f ms queued\n", frames,
+			   input.eventsReceived(), input.eventsDispatched(), direct.total() / frames, queued.total() / frames);
+		return true;
+	}
+}
@@ -0,0 +1,160 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Frame/Stripe.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace toy
+{
+	// hardware event counter for the calling thread, counts nothing where the platform doesn't provide one
+	class PerfCounter
+	{
+	public:
+		PerfCounter(bool branchMisses)
+			: m_fd(-1)
+		{
+#ifdef __linux__
+			perf_event_attr attr = {};
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.size = sizeof(attr);
+			attr.config = branchMisses ? PERF_COUNT_HW_BRANCH_MISSES : PERF_COUNT_HW_INSTRUCTIONS;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			m_fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+			UNUSED(branchMisses);
+#endif
+		}
+
+		~PerfCounter()
+		{
+#ifdef __linux__
+			if(m_fd >= 0)
+				close(m_fd);
+#endif
+		}
+
+		bool valid() { return m_fd >= 0; }
+
+		void start()
+		{
+#ifdef __linux__
+			if(m_fd < 0)
+				return;
+			ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+		}
+
+		uint64_t stop()
+		{
+			uint64_t count = 0;
+#ifdef __linux__
+			if(m_fd < 0 || ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0) < 0 || read(m_fd, &count, sizeof(count)) != sizeof(count))
+				return 0;
+#endif
+			return count;
+		}
+
+	protected:
+		int m_fd;
+	};
+
+	// the canvas lays out its nodes by switching the flow of their style in place : the kernel of a frame follows the live style, as the generic passes do
+	static bool benchmarkFlowSwitch(Container& sheet)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		Style& style = sheet.fetchStyle(Label::cls());
+		Flow flow = style.layout().d_flow;
+
+		bool passed = true;
+		std::vector<float> reference;
+		for(bool kernels : { false, true })
+		{
+			Stripe::s_layoutKernels = kernels;
+
+			style.layout().d_flow = FREE;
+			Container& list = sheet.emplace<Container>();
+			for(size_t i = 0; i < 100; ++i)
+				list.emplace<Label>("Item " + std::to_string(i));
+			layer.relayout();
+
+			style.layout().d_flow = FLOW;
+			layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+			layer.relayout();
+			style.layout().d_flow = flow;
+
+			std::vector<float> geometry = collectGeometry(layer);
+			if(!kernels)
+				reference = geometry;
+
+			printf("INFO: kernel benchmark, style flow switched in place, %s : %s\n", kernels ? "kernel table" : "generic passes", checkGeometry(geometry, reference, passed));
+			sheet.release(list);
+		}
+
+		return passed;
+	}
+
+	// the same relayouts through the generic passes and through the kernel table, counting instructions and branch misses where possible
+	TOY_BENCHMARK(Kernels)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const size_t iterations = 100;
+		bool passed = true;
+
+		Container* deepest = nullptr;
+		createDeepTree(sheet, 200, deepest);
+		layer.relayout();
+
+		PerfCounter instructions(false);
+		PerfCounter branchMisses(true);
+
+		std::vector<float> reference;
+		for(bool kernels : { false, true })
+		{
+			Stripe::s_layoutKernels = kernels;
+
+			Stopwatch stopwatch;
+			uint64_t instructionCount = 0;
+			uint64_t branchMissCount = 0;
+			for(size_t i = 0; i < iterations; ++i)
+			{
+				layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+
+				stopwatch.start();
+				instructions.start();
+				branchMisses.start();
+				layer.relayout();
+				branchMissCount += branchMisses.stop();
+				instructionCount += instructions.stop();
+				stopwatch.stop();
+			}
+
+			std::vector<float> geometry = collectGeometry(layer);
+			if(!kernels)
+				reference = geometry;
+
+			const char* name = kernels ? "kernel table" : "generic passes";
+			const char* check = checkGeometry(geometry, reference, passed);
+			if(instructions.valid())
+				printf("INFO: kernel benchmark, deep tree, %s : %.3f ms, %llu instructions, %llu branch misses per relayout, %s\n", name, stopwatch.total() / iterations,
+					   (unsigned long long) (instructionCount / iterations), (unsigned long long) (branchMissCount / iterations), check);
+			else
+				printf("INFO: kernel benchmark, deep tree, %s : %.3f ms per relayout, no hardware counters, %s\n", name, stopwatch.total() / iterations, check);
+		}
+
+		passed &= benchmarkFlowSwitch(sheet);
+
+		Stripe::s_layoutKernels = true;
+		return passed;
+	}
+}
@@ -0,0 +1,122 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Render/Renderer.h>
+
+#include <GLFW/glfw3.h>
+
+#ifndef GL_FRAMEBUFFER_BINDING
+	#define GL_FRAMEBUFFER_BINDING 0x8CA6
+#endif
+
+#include <cmath>
+#include <cstdlib>
+
+namespace toy
+{
+	// pixels of an area of the back buffer, read right after the render
+	static std::vector<unsigned char> readPixels(MasterLayer& layer, const BoxFloat& rect)
+	{
+		int x = int(rect.x());
+		int y = int(layer.height()) - int(rect.y() + rect.h());
+		std::vector<unsigned char> pixels(size_t(rect.w()) * size_t(rect.h()) * 4);
+		glReadPixels(x, y, GLsizei(rect.w()), GLsizei(rect.h()), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		return pixels;
+	}
+
+	// dragging a cached window composites the same texture at each place, instead of recording and rasterizing its content again
+	TOY_BENCHMARK(LayerCache)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		MasterLayer& layer = rootSheet.frame().as<MasterLayer>();
+		Renderer& renderer = rootSheet.uiWindow().renderer();
+		const size_t count = 100;
+
+		Window& window = sheet.emplace<Window>("Layer Cache");
+		for(size_t i = 0; i < 100; ++i)
+			window.emplace<Label>("Item " + std::to_string(i));
+
+		layer.relayout();
+		Layer& windowLayer = window.frame().as<Layer>();
+		DimFloat origin(window.frame().dposition(DIM_X), window.frame().dposition(DIM_Y));
+
+		auto drag = [&](bool cacheable) {
+			windowLayer.setCacheable(cacheable);
+			size_t recorded = 0;
+			size_t textures = 0;
+			Stopwatch stopwatch;
+			for(size_t i = 0; i < count; ++i)
+			{
+				stopwatch.time([&] {
+					window.frame().setPosition(origin.x() + float(i % 50), origin.y() + float(i % 30));
+					layer.relayout();
+					layer.redraw();
+					rootSheet.target().render();
+				});
+				recorded += renderer.recordedSegments();
+				textures += renderer.layerTextures();
+			}
+
+			printf("INFO: layer cache benchmark, dragging a %s window : %.1f segments recorded, %.2f textures rendered, %.3f us per render\n",
+				   cacheable ? "cached" : "uncached", double(recorded) / count, double(textures) / count, stopwatch.total() * 1000.0 / count);
+		};
+
+		drag(false);
+		drag(true);
+
+		// at a position off the pixel grid, the window composited from its texture looks the same as the window drawn directly,
+		// and the target framebuffer and viewport are restored once the texture is rendered
+		window.frame().setPosition(origin.x() + 10.5f, origin.y() + 7.25f);
+		layer.relayout();
+		BoxFloat area = windowLayer.absoluteRect();
+		area = BoxFloat(std::floor(area.x()), std::floor(area.y()), std::ceil(area.x() + area.w()) - std::floor(area.x()), std::ceil(area.y() + area.h()) - std::floor(area.y()));
+
+		auto capture = [&](bool cacheable) {
+			windowLayer.setCacheable(cacheable);
+			layer.setForceRedraw();
+			windowLayer.setForceRedraw();
+			layer.damageAll();
+			layer.redraw();
+			rootSheet.target().render();
+			return readPixels(layer, area);
+		};
+
+		std::vector<unsigned char> direct = capture(false);
+		std::vector<unsigned char> textured = capture(true);
+		size_t textures = renderer.layerTextures();
+
+		GLint framebuffer = -1;
+		GLint viewport[4] = { 0, 0, 0, 0 };
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		bool restored = framebuffer == 0 && viewport[2] == GLint(layer.width()) && viewport[3] == GLint(layer.height());
+
+		size_t different = 0;
+		for(size_t i = 0; i < direct.size(); i += 4)
+			for(size_t c = 0; c < 4; ++c)
+				if(std::abs(int(direct[i + c]) - int(textured[i + c])) > 4)
+				{
+					++different;
+					break;
+				}
+
+		bool identical = textures > 0 && different * 1000 <= direct.size() / 4;
+		printf("INFO: layer cache benchmark, %zu texture rendered, %zu of %zu pixels differ from the direct render, target %s\n",
+			   textures, different, direct.size() / 4, restored ? "restored" : "NOT RESTORED");
+
+		windowLayer.setCacheable(false);
+
+		// with the setting on the master layer, a window opened afterwards is cached as well
+		layer.setCacheLayers(true);
+		Window& opened = sheet.emplace<Window>("Opened Later");
+		layer.relayout();
+		bool inherited = opened.frame().as<Layer>().cacheable();
+		layer.setCacheLayers(false);
+		sheet.release(opened);
+
+		printf("INFO: layer cache benchmark, window opened with cached layers : %s\n", inherited ? "cached" : "NOT CACHED");
+		return identical && restored && inherited;
+	}
+}
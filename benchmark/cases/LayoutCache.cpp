@@ -0,0 +1,87 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+
+namespace toy
+{
+	// same constraints and contents : frames are only checked against their layout keys, and keep their geometry
+	static bool benchmarkUnchanged(MasterLayer& layer, const char* tree, size_t iterations)
+	{
+		layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+		layer.relayout();
+		std::vector<float> reference = collectGeometry(layer);
+
+		Stopwatch stopwatch;
+		for(size_t i = 0; i < iterations; ++i)
+		{
+			layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_LAYOUT); return true; });
+			stopwatch.time([&] { layer.relayout(); });
+		}
+
+		bool passed = true;
+		printf("INFO: layout cache benchmark, %s tree, unchanged constraints : %.3f ms per relayout, %zu frames visited, %s\n", tree, stopwatch.total() / iterations,
+			   layer.layoutVisits(), checkGeometry(collectGeometry(layer), reference, passed));
+		return passed;
+	}
+
+	// what each widget does on its next frame when its style was updated
+	static void restyle(MasterLayer& layer, Style& style)
+	{
+		layer.visit([&style](Frame& frame) { if(&frame.style() == &style) frame.setStyle(style); return true; });
+	}
+
+	// a padding change keeps the size of the frame : it must miss the cache, and give the geometry of a relayout from scratch
+	static bool benchmarkRestyled(MasterLayer& layer, Container& sheet)
+	{
+		layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+		layer.relayout();
+		layer.redraw();
+		std::vector<float> before = collectGeometry(layer);
+
+		Style& style = sheet.style();
+		BoxFloat padding = style.layout().padding();
+		style.layout().padding() = BoxFloat(padding[0] + 10.f, padding[1] + 10.f, padding[2] + 10.f, padding[3] + 10.f);
+		style.markUpdate();
+		restyle(layer, style);
+
+		Stopwatch stopwatch;
+		stopwatch.time([&] { layer.relayout(); });
+		std::vector<float> geometry = collectGeometry(layer);
+
+		layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+		layer.relayout();
+		std::vector<float> reference = collectGeometry(layer);
+
+		style.layout().padding() = padding;
+		style.markUpdate();
+		restyle(layer, style);
+		layer.relayout();
+
+		bool passed = geometry != before;
+		printf("INFO: layout cache benchmark, padding changed at the same size : %.3f ms, %s, %s\n", stopwatch.total(), passed ? "moved" : "NOT MOVED",
+			   checkGeometry(geometry, reference, passed));
+		return passed;
+	}
+
+	TOY_BENCHMARK(LayoutCache)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		bool passed = true;
+
+		Container* deepest = nullptr;
+		createDeepTree(sheet, 200, deepest);
+		layer.relayout();
+		passed &= benchmarkUnchanged(layer, "deep", 100);
+
+		Container* list = nullptr;
+		createWideTree(sheet, 10000, list);
+		layer.relayout();
+		passed &= benchmarkUnchanged(layer, "wide", 20);
+
+		passed &= benchmarkRestyled(layer, sheet);
+
+		return passed;
+	}
+}
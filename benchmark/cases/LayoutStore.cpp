@@ -0,0 +1,96 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+
+namespace toy
+{
+	// full relayouts through the stripe passes and through the layout store, which must produce the same geometry
+	static bool benchmarkStore(MasterLayer& layer, const char* tree, size_t iterations)
+	{
+		bool passed = true;
+		std::vector<float> reference;
+		for(bool store : { false, true })
+		{
+			layer.setLayoutStore(store);
+
+			Stopwatch stopwatch;
+			for(size_t i = 0; i < iterations; ++i)
+			{
+				layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+				stopwatch.time([&] { layer.relayout(); });
+			}
+
+			std::vector<float> geometry = collectGeometry(layer);
+			if(!store)
+				reference = geometry;
+
+			printf("INFO: layout store benchmark, %s tree, %s : %.3f ms per relayout, %zu frames visited, %s\n", tree, store ? "layout store" : "stripe passes",
+				   stopwatch.total() / iterations, layer.layoutVisits(), checkGeometry(geometry, reference, passed));
+		}
+
+		layer.setLayoutStore(false);
+		return passed;
+	}
+
+	// a single label changing its text : the store only reads and writes back the rows along its path, and must still match the stripe passes
+	static bool benchmarkIncremental(MasterLayer& layer, Widget& item, size_t iterations)
+	{
+		bool passed = true;
+		std::vector<float> reference;
+		for(bool store : { false, true })
+		{
+			layer.setLayoutStore(store);
+			layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+			layer.relayout();
+			layer.redraw();
+
+			size_t loaded = 0;
+			size_t stored = 0;
+			Stopwatch stopwatch;
+			for(size_t i = 0; i < iterations; ++i)
+			{
+				item.setLabel(i % 2 ? "Item" : "Item with a longer label");
+				stopwatch.time([&] { layer.relayout(); });
+				loaded += layer.layoutLoaded();
+				stored += layer.layoutStored();
+				layer.redraw();
+			}
+
+			std::vector<float> geometry = collectGeometry(layer);
+			if(!store)
+				reference = geometry;
+
+			printf("INFO: layout store benchmark, one label changing, %s : %.3f ms per relayout, %zu rows loaded, %zu rows stored per relayout, %s\n", store ? "layout store" : "stripe passes",
+				   stopwatch.total() / iterations, loaded / iterations, stored / iterations, checkGeometry(geometry, reference, passed));
+		}
+
+		layer.setLayoutStore(false);
+		return passed;
+	}
+
+	TOY_BENCHMARK(LayoutStore)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		bool passed = true;
+
+		Container* deepest = nullptr;
+		createDeepTree(sheet, 200, deepest);
+		layer.relayout();
+		passed &= benchmarkStore(layer, "deep", 100);
+
+		Container* list = nullptr;
+		createWideTree(sheet, 10000, list);
+		layer.relayout();
+		passed &= benchmarkStore(layer, "wide", 20);
+
+		createLayeredTree(sheet, 8, 2000);
+		layer.relayout();
+		passed &= benchmarkStore(layer, "layered", 20);
+
+		passed &= benchmarkIncremental(layer, *list->contents()[list->contents().size() / 2], 100);
+
+		return passed;
+	}
+}
@@ -0,0 +1,51 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Render/Renderer.h>
+
+namespace toy
+{
+	// a window covering the whole target with an opaque background hides every layer beneath it, which are then left out
+	TOY_BENCHMARK(Occlusion)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		MasterLayer& layer = rootSheet.frame().as<MasterLayer>();
+		Renderer& renderer = rootSheet.uiWindow().renderer();
+		const size_t count = 100;
+
+		createLayeredTree(sheet, 8, 200);
+		Window& cover = sheet.emplace<Window>("Cover");
+
+		auto repaint = [&](bool covered) {
+			if(covered)
+				cover.show();
+			else
+				cover.hide();
+			cover.frame().setPosition(0.f, 0.f);
+			cover.frame().setSize(layer.width(), layer.height());
+			layer.relayout();
+			layer.redraw();
+
+			size_t occluded = 0;
+			size_t drawn = 0;
+			Stopwatch stopwatch;
+			for(size_t i = 0; i < count; ++i)
+			{
+				layer.damageAll();
+				stopwatch.time([&] { rootSheet.target().render(); });
+				occluded += renderer.occludedLayers();
+				drawn += renderer.drawnFrames();
+			}
+
+			printf("INFO: occlusion benchmark, %s : %.1f layers occluded, %.1f frames drawn, %.3f us per render\n",
+				   covered ? "covered by a window" : "uncovered", double(occluded) / count, double(drawn) / count, stopwatch.total() * 1000.0 / count);
+			return occluded;
+		};
+
+		bool passed = repaint(false) == 0;
+		passed &= repaint(true) > 0;
+		return passed;
+	}
+}
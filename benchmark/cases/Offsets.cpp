@@ -0,0 +1,115 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Frame/Stripe.h>
+
+#include <algorithm>
+
+namespace toy
+{
+	// the scrollbar of a scaled list keeps a scaled cursor : scrolling by one item from a boundary reaches the next one, forward and backward
+	static bool benchmarkScaledScroll(Container& sheet)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const float scale = 1.37f;
+
+		Window& window = sheet.emplace<Window>("Scaled Offsets");
+		ScrollSheet& panel = window.emplace<ScrollSheet>();
+		Container& list = panel.container();
+		for(size_t i = 0; i < 1000; ++i)
+			list.emplace<Label>("Item " + std::to_string(i));
+
+		Stripe& stripe = list.stripe();
+		Dimension dim = stripe.length();
+		Scrollbar& scrollbar = window.emplace<Scrollbar>(*list.parent(), list, dim);
+		list.frame().setScale(scale);
+		layer.relayout();
+
+		float overflow = scrollbar.overflow();
+		auto cursor = [&] { return -list.frame().dposition(dim); };
+
+		// each step forward lands on the scaled end of the next item, until the end of the overflow
+		size_t forward = 0;
+		bool consistent = overflow > 0.f;
+		for(Frame* frame : stripe.contents())
+		{
+			float end = std::min((frame->dposition(dim) + frame->dsize(dim)) * scale, overflow);
+			if(cursor() >= end)
+				continue;
+
+			scrollbar.scrolldown();
+			++forward;
+			consistent &= cursor() == end;
+			if(end == overflow)
+				break;
+		}
+
+		// and each step back on the scaled start of the previous one
+		size_t backward = 0;
+		for(auto it = stripe.contents().rbegin(); it != stripe.contents().rend(); ++it)
+		{
+			float start = std::max((*it)->dposition(dim) * scale, 0.f);
+			if(cursor() <= start)
+				continue;
+
+			scrollbar.scrollup();
+			++backward;
+			consistent &= cursor() == start;
+		}
+
+		bool passed = consistent && forward > 0 && backward > 0;
+		printf("INFO: offset benchmark, scrolling a list at scale %.2f : %zu steps forward, %zu back, %s\n", scale, forward, backward, passed ? "consistent" : "INCONSISTENT");
+
+		sheet.release(window);
+		return passed;
+	}
+
+	// sequence offsets looked up by bisection along a list of 10000 items, and the item boundaries scrolling steps through
+	TOY_BENCHMARK(Offsets)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const size_t queries = 100000;
+
+		Container* list = nullptr;
+		createWideTree(sheet, 10000, list);
+		layer.relayout();
+
+		Stripe& stripe = list->stripe();
+		Dimension dim = stripe.length();
+		float size = stripe.dsize(dim);
+
+		float sum = 0.f;
+		Stopwatch stopwatch;
+		stopwatch.time([&] {
+			for(size_t i = 0; i < queries; ++i)
+			{
+				float pos = size * float(i) / float(queries);
+				sum += stripe.nextOffset(dim, pos) - stripe.prevOffset(dim, pos);
+			}
+		});
+
+		printf("INFO: offset benchmark, %zu frames : %.3f us per next / prev query pair (%.1f)\n", stripe.contents().size(), stopwatch.total() * 1000.0 / queries, sum / queries);
+
+		// single steps must move past every item, and a step of several items lands where as many single steps do
+		size_t count = stripe.contents().size();
+		float first = stripe.contents().front()->dposition(dim);
+		float pos = first;
+		float tenth = 0.f;
+		size_t steps = 0;
+		while(steps < count)
+		{
+			float next = stripe.stepOffset(dim, pos, 1);
+			if(next <= pos)
+				break;
+			pos = next;
+			if(++steps == 10)
+				tenth = pos;
+		}
+
+		bool passed = steps == count && stripe.stepOffset(dim, first, 10) == tenth && stripe.stepOffset(dim, pos, -int(count)) == first;
+		printf("INFO: offset benchmark, stepping : %zu of %zu items stepped through, %s\n", steps, count, passed ? "consistent" : "INCONSISTENT");
+		return benchmarkScaledScroll(sheet) && passed;
+	}
+}
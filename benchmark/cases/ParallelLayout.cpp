@@ -0,0 +1,44 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+
+#include <thread>
+
+namespace toy
+{
+	// sublayers laid out on the worker pool must end up with the geometry of a single threaded relayout
+	TOY_BENCHMARK(ParallelLayout)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const size_t iterations = 20;
+		bool passed = true;
+
+		createLayeredTree(sheet, 8, 2000);
+		layer.relayout();
+
+		std::vector<float> reference;
+		for(bool parallel : { false, true })
+		{
+			size_t threads = parallel ? std::max(1U, std::thread::hardware_concurrency()) - 1 : 0;
+			layer.setLayoutThreads(threads);
+
+			Stopwatch stopwatch;
+			for(size_t i = 0; i < iterations; ++i)
+			{
+				layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+				stopwatch.time([&] { layer.relayout(); });
+			}
+
+			std::vector<float> geometry = collectGeometry(layer);
+			if(!parallel)
+				reference = geometry;
+
+			printf("INFO: parallel layout benchmark, layered tree, %zu worker threads : %.3f ms per relayout, %s\n", threads, stopwatch.total() / iterations, checkGeometry(geometry, reference, passed));
+		}
+
+		layer.setLayoutThreads(0);
+		return passed;
+	}
+}
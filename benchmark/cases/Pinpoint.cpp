@@ -0,0 +1,51 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+
+namespace toy
+{
+	// hit tests through a walk of the tree and through the per-layer grid index, which must find the same frames
+	TOY_BENCHMARK(Pinpoint)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const size_t queries = 100000;
+
+		createLayeredTree(sheet, 8, 2000);
+		layer.relayout();
+		layer.redraw();
+
+		Frame::Filter opaque = [](Frame& frame) { return frame.opaque(); };
+
+		bool passed = true;
+		std::vector<Frame*> reference;
+		for(bool indexed : { false, true })
+		{
+			Layer::s_hitIndex = indexed;
+
+			std::vector<Frame*> targets;
+			targets.reserve(queries);
+
+			Stopwatch stopwatch;
+			stopwatch.time([&] {
+				for(size_t i = 0; i < queries; ++i)
+				{
+					float x = float(i * 7919 % 1000) / 1000.f * layer.width();
+					float y = float(i * 104729 % 1000) / 1000.f * layer.height();
+					targets.push_back(layer.pinpoint(x, y, opaque));
+				}
+			});
+
+			if(!indexed)
+				reference = targets;
+
+			bool identical = targets == reference;
+			passed &= identical;
+			printf("INFO: pinpoint benchmark, layered tree, %s : %.3f us per query, %s\n", indexed ? "hit index" : "tree walk", stopwatch.total() * 1000.0 / queries, identical ? "identical" : "MISMATCH");
+		}
+
+		Layer::s_hitIndex = true;
+		return passed;
+	}
+}
@@ -0,0 +1,54 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+
+namespace toy
+{
+	// batched changes to a list of 100000 items, each followed by the relayout it triggers
+	TOY_BENCHMARK(Rebuild)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const size_t count = 100000;
+
+		Container& list = sheet.emplace<Window>("Rebuild").emplace<Container>();
+
+		auto time = [&layer](const char* operation, const std::function<void()>& change)
+		{
+			Stopwatch stopwatch;
+			stopwatch.time([&] { change(); layer.relayout(); });
+			printf("INFO: rebuild benchmark, %s : %.3f ms\n", operation, stopwatch.total());
+		};
+
+		auto items = [&list, count]()
+		{
+			std::vector<unique_ptr<Widget>> widgets;
+			widgets.reserve(count);
+			for(size_t i = 0; i < count; ++i)
+				widgets.push_back(make_unique<Label>(list, "Item " + std::to_string(i)));
+			return widgets;
+		};
+
+		std::vector<size_t> reversed(count);
+		for(size_t i = 0; i < count; ++i)
+			reversed[i] = count - 1 - i;
+
+		time("append", [&] { list.append(items()); });
+		time("reorder", [&] { list.reorder(reversed); });
+		time("replace", [&] { list.replace(items()); });
+		// the siblings of removed items stay bound, their absolute position is right before the relayout
+		Frame& sibling = list.contents().front()->frame();
+		DimFloat position = sibling.absolutePosition();
+		bool passed = false;
+
+		time("remove range", [&] {
+			list.release(count / 4, count / 2);
+			passed = sibling.parent() == &list.stripe() && sibling.absolutePosition()[DIM_X] == position[DIM_X] && sibling.absolutePosition()[DIM_Y] == position[DIM_Y];
+		});
+		printf("INFO: rebuild benchmark, sibling after remove range : %s\n", passed ? "bound in place" : "WRONG POSITION");
+
+		time("clear", [&] { list.clear(); });
+		return passed;
+	}
+}
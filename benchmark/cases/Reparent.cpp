@@ -0,0 +1,58 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+
+namespace toy
+{
+	// binding and unbinding don't visit the subtree anymore, the time of a move doesn't depend on its size
+	TOY_BENCHMARK(Reparent)
+	{
+		const size_t count = 10000;
+		const size_t moves = 100;
+
+		Window& window = sheet.emplace<Window>("Reparent");
+		Container& from = window.emplace<Container>();
+		Container& to = window.emplace<Container>();
+
+		Container& subtree = from.emplace<Container>();
+		for(size_t i = 0; i < count; ++i)
+			subtree.emplace<Label>("Item " + std::to_string(i));
+
+		Stopwatch stopwatch;
+		stopwatch.time([&] {
+			for(size_t i = 0; i < moves; ++i)
+			{
+				Container& source = i % 2 ? to : from;
+				Container& target = i % 2 ? from : to;
+				target.append(source.release(subtree));
+			}
+		});
+
+		printf("INFO: reparent benchmark, subtree of %zu widgets : %.3f us per move\n", count, stopwatch.total() * 1000.0 / moves);
+
+		// a handle on a widget of the moved subtree resolves only while it is attached, and after the first lookup without walking up to the root
+		const size_t lookups = 100000;
+		Widget& item = subtree.at(count - 1);
+		ReceiverHandle handle = item.handle();
+		Container& holder = subtree.parent() == &from ? from : to;
+
+		unique_ptr<Widget> detached = holder.release(subtree);
+		bool skipped = handle.live() == nullptr;
+		holder.append(std::move(detached));
+		bool resolved = handle.live() == &item;
+
+		size_t live = 0;
+		Stopwatch lookup;
+		lookup.time([&] {
+			for(size_t i = 0; i < lookups; ++i)
+				live += handle.live() != nullptr;
+		});
+
+		bool passed = skipped && resolved && live == lookups;
+		printf("INFO: reparent benchmark, handle into the moved subtree : %s while detached, %s once attached, %.4f us per lookup\n",
+			   skipped ? "skipped" : "NOT SKIPPED", resolved ? "resolved" : "NOT RESOLVED", lookup.total() * 1000.0 / lookups);
+		return passed;
+	}
+}
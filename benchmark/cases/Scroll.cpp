@@ -0,0 +1,55 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Render/Renderer.h>
+
+namespace toy
+{
+	// scrolling only moves the scrolled container : nothing is laid out again, and only the items scrolled into view are recorded
+	TOY_BENCHMARK(Scroll)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		MasterLayer& layer = rootSheet.frame().as<MasterLayer>();
+		Renderer& renderer = rootSheet.uiWindow().renderer();
+		const size_t count = 120;
+
+		Window& window = sheet.emplace<Window>("Scroll");
+		ScrollSheet& full = window.emplace<ScrollSheet>();
+		for(size_t i = 0; i < 10000; ++i)
+			full.emplace<Label>("Item " + std::to_string(i));
+		ScrollSheet& empty = window.emplace<ScrollSheet>();
+
+		auto scroll = [&](ScrollSheet& panel, const char* name) {
+			Frame& container = panel.container().frame();
+			layer.relayout();
+			layer.redraw();
+			rootSheet.target().render();
+
+			size_t recorded = 0;
+			size_t visits = 0;
+			Stopwatch stopwatch;
+			for(size_t i = 0; i < count; ++i)
+			{
+				stopwatch.start();
+				container.setPositionDim(DIM_Y, -float(i % 60) * 4.f);
+				layer.relayout();
+				visits += layer.layoutVisits();
+				layer.redraw();
+				rootSheet.target().render();
+				stopwatch.stop();
+				recorded += renderer.recordedSegments();
+			}
+
+			printf("INFO: scroll benchmark, %s panel : %.1f segments recorded, %.1f frames laid out, %.3f us per frame\n",
+				   name, double(recorded) / count, double(visits) / count, stopwatch.total() * 1000.0 / count);
+
+			container.setPositionDim(DIM_Y, 0.f);
+		};
+
+		scroll(full, "10000 items");
+		scroll(empty, "empty");
+		return true;
+	}
+}
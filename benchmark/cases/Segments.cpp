@@ -0,0 +1,46 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Render/Renderer.h>
+
+namespace toy
+{
+	// hovering a widget records its own segment again, the rest of its layer is replayed as it was
+	TOY_BENCHMARK(Segments)
+	{
+		RootSheet& rootSheet = sheet.rootSheet();
+		MasterLayer& layer = rootSheet.frame().as<MasterLayer>();
+		Renderer& renderer = rootSheet.uiWindow().renderer();
+		const size_t count = 100;
+
+		Window& window = sheet.emplace<Window>("Segments");
+		for(size_t i = 0; i < 100; ++i)
+			window.emplace<Label>("Item " + std::to_string(i));
+		Button& button = window.emplace<Button>("Hover");
+
+		layer.relayout();
+		layer.redraw();
+		rootSheet.target().render();
+
+		size_t recorded = 0;
+		size_t reused = 0;
+		Stopwatch stopwatch;
+		for(size_t i = 0; i < count; ++i)
+		{
+			stopwatch.time([&] {
+				button.toggleState(HOVERED);
+				layer.relayout();
+				layer.redraw();
+				rootSheet.target().render();
+			});
+			recorded += renderer.recordedSegments();
+			reused += renderer.reusedSegments();
+		}
+
+		printf("INFO: segment benchmark, hovering a widget : %.1f segments recorded, %.1f replayed, %.3f us per render\n",
+			   double(recorded) / count, double(reused) / count, stopwatch.total() * 1000.0 / count);
+		return true;
+	}
+}
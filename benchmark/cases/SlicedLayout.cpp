@@ -0,0 +1,101 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+#include <toyui/Frame/Stripe.h>
+
+#include <algorithm>
+
+namespace toy
+{
+	// labels inserted and removed between the slices of a pass are laid out by it, and the stripes it went through are indexed again once it completes
+	static bool benchmarkChurn(Container& sheet)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const float budget = 0.2f;
+		const size_t churns = 30;
+
+		Container* list = nullptr;
+		Window& window = createWideTree(sheet, 5000, list);
+
+		layer.setLayoutBudget(budget);
+		layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+
+		size_t slices = 0;
+		size_t churned = 0;
+		do
+		{
+			layer.relayout();
+			++slices;
+			if(layer.layoutPending() && slices % 3 == 0 && churned < churns)
+			{
+				size_t index = (churned * 997) % list->count();
+				list->insert(make_unique<Label>(*list, "Inserted " + std::to_string(churned)), index);
+				list->release(list->at((index + list->count() / 2) % list->count()));
+				++churned;
+			}
+		}
+		while(layer.layoutPending());
+
+		layer.setLayoutBudget(0.f);
+
+		// the offsets of the list are searchable without going through the stripe passes
+		Stripe& stripe = list->stripe();
+		Dimension dim = stripe.length();
+		float middle = stripe.dsize(dim) / 2.f;
+		size_t first = 0;
+		size_t last = 0;
+		bool indexed = stripe.shownRange(middle, middle + 1.f, first, last) && first < last;
+		if(indexed)
+		{
+			Frame& frame = *stripe.contents()[stripe.shown()[first]];
+			indexed = frame.dposition(dim) <= middle && frame.dposition(dim) + frame.dsize(dim) > middle;
+		}
+
+		std::vector<float> geometry = collectGeometry(layer);
+
+		layer.setLayoutStore(false);
+		layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+		layer.relayout();
+
+		bool passed = indexed;
+		printf("INFO: sliced layout benchmark, %zu labels inserted and removed between %zu slices : offsets %s, %s\n", churned * 2, slices, indexed ? "indexed" : "NOT INDEXED",
+			   checkGeometry(geometry, collectGeometry(layer), passed));
+
+		sheet.release(window);
+		return passed;
+	}
+
+	// a relayout split in slices within a time budget, resumed until done, must end with the geometry of a single relayout
+	TOY_BENCHMARK(SlicedLayout)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const float budget = 4.f;
+
+		createLayeredTree(sheet, 8, 2000);
+		layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+		layer.relayout();
+		std::vector<float> reference = collectGeometry(layer);
+
+		layer.setLayoutBudget(budget);
+		layer.visit([](Frame& frame) { frame.markDirty(Frame::DIRTY_CONTENT); return true; });
+
+		size_t slices = 0;
+		double longest = 0.0;
+		Stopwatch stopwatch;
+		do
+		{
+			longest = std::max(longest, stopwatch.time([&] { layer.relayout(); }));
+			++slices;
+		}
+		while(layer.layoutPending());
+
+		layer.setLayoutBudget(0.f);
+
+		bool passed = true;
+		printf("INFO: sliced layout benchmark, layered tree, %.1f ms budget : %zu slices, longest %.3f ms, %.3f ms in total, %s\n", budget, slices, longest, stopwatch.total(),
+			   checkGeometry(collectGeometry(layer), reference, passed));
+		return benchmarkChurn(sheet) && passed;
+	}
+}
@@ -0,0 +1,67 @@
+
+#include <Benchmark.h>
+
+#include <toyui/Types.h>
+#include <toyui/Frame/Layer.h>
+
+#include <cmath>
+
+namespace toy
+{
+	// an event converted to local coordinates at each step of its propagation chain, with or without a frame moving in between
+	// a sibling window moving leaves the cached transforms of the chain valid, the window of the chain moving invalidates them
+	TOY_BENCHMARK(Transforms)
+	{
+		MasterLayer& layer = sheet.rootSheet().frame().as<MasterLayer>();
+		const size_t events = 1000;
+
+		Container* deepest = nullptr;
+		Window& window = createDeepTree(sheet, 200, deepest);
+		Window& sibling = sheet.emplace<Window>("Sibling");
+		layer.relayout();
+
+		std::vector<Frame*> chain;
+		for(Frame* frame = &deepest->frame(); frame != &layer; frame = frame->parent())
+			chain.push_back(frame);
+
+		auto convert = [&](const char* name, Frame* moving) {
+			Stopwatch walked;
+			Stopwatch cached;
+			bool identical = true;
+			std::vector<DimFloat> reference(chain.size());
+			for(size_t i = 0; i < events; ++i)
+			{
+				if(moving)
+					moving->setPosition(moving->left() + (i % 2 ? 1.f : -1.f), moving->top());
+
+				float x = float(i % 100);
+				float y = float(i % 50);
+
+				walked.time([&] {
+					for(size_t k = 0; k < chain.size(); ++k)
+					{
+						reference[k] = DimFloat(x, y);
+						chain[k]->integratePosition(layer, reference[k]);
+					}
+				});
+				cached.time([&] {
+					for(size_t k = 0; k < chain.size(); ++k)
+					{
+						DimFloat local = chain[k]->localPosition(x, y);
+						identical &= std::abs(local.x() - reference[k].x()) < 0.01f && std::abs(local.y() - reference[k].y()) < 0.01f;
+					}
+				});
+			}
+
+			printf("INFO: transform benchmark, chain of %zu frames%s : %.3f us per event walking the tree, %.3f us cached, %s\n", chain.size(), name,
+				   walked.total() * 1000.0 / events, cached.total() * 1000.0 / events, identical ? "identical" : "MISMATCH");
+			return identical;
+		};
+
+		bool passed = true;
+		passed &= convert("", nullptr);
+		passed &= convert(", sibling moving", &sibling.frame());
+		passed &= convert(", moving", &window.frame());
+		return passed;
+	}
+}
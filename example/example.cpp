@@ -3,6 +3,12 @@
 #include <UiExample.h>
 
 #include <toyui/Types.h>
+#include <toyui/Input/InputRecorder.h>
+#include <toyui/Input/InputDispatcher.h>
+#include <toyui/Frame/Layer.h>
+
+#include <algorithm>
+#include <cstring>
 
 #ifdef TOY_PLATFORM_EMSCRIPTEN
 	#include <toyui/Context/EmscriptenContext.h>
@@ -22,6 +28,47 @@
 	#define TOYUI_RESOURCE_PATH "../../data/"
 #endif
 
+void replayInput(toy::UiWindow& uiwindow, const char* path)
+{
+	toy::InputReplay replay(uiwindow, path);
+	if(!replay.loaded())
+		return;
+
+	while(replay.nextFrame())
+		;
+
+	// the first frames lay out the whole interface, they are reported but left out of the averages
+	const std::vector<toy::FrameTimings>& timings = replay.timings();
+	size_t warmup = std::min<size_t>(2, timings.size());
+	double total = 0.0;
+	double worst = 0.0;
+	size_t worstFrame = 0;
+	toy::FrameTimings sum = {};
+	for(size_t i = 0; i < timings.size(); ++i)
+	{
+		const toy::FrameTimings& frame = timings[i];
+		double time = frame.input + frame.layout + frame.redraw + frame.update + frame.render;
+		if(i < warmup)
+		{
+			printf("INFO: replay frame %zu (warmup) : %.3f ms\n", i, time);
+			continue;
+		}
+
+		sum.input += frame.input; sum.layout += frame.layout; sum.redraw += frame.redraw; sum.update += frame.update; sum.render += frame.render;
+		total += time;
+		if(time > worst)
+		{
+			worst = time;
+			worstFrame = i;
+		}
+	}
+
+	size_t count = std::max<size_t>(1, timings.size() - warmup);
+	uiwindow.latency().report();
+	printf("INFO: replayed %zu frames of %s : %.3f ms per frame, input %.3f, layout %.3f, redraw %.3f, update %.3f, render %.3f, worst frame %zu at %.3f ms\n",
+		   timings.size(), path, total / count, sum.input / count, sum.layout / count, sum.redraw / count, sum.update / count, sum.render / count, worstFrame, worst);
+}
+
 int main(int argc, char *argv[])
 {
 #ifdef TOY_PLATFORM_EMSCRIPTEN
@@ -39,8 +86,31 @@ int main(int argc, char *argv[])
 	gWindow = &uiwindow;
 	emscripten_set_main_loop(iterate, 0, 1);
 #else
+	// --record <file> saves the input of the session, --replay <file> runs a recorded session and reports frame timings
+	// --input-thread collects input on a separate thread, where the backend allows it
+	// --cache-layers composites each layer from a texture, rendered again only when its content changes
+	if(argc > 1 && strcmp(argv[1], "--input-thread") == 0)
+	{
+		uiwindow.context().inputWindow().setInputThread(true);
+	}
+	else if(argc > 1 && strcmp(argv[1], "--cache-layers") == 0)
+	{
+		uiwindow.rootSheet().frame().as<toy::MasterLayer>().setCacheLayers(true);
+	}
+	else if(argc > 2 && strcmp(argv[1], "--replay") == 0)
+	{
+		replayInput(uiwindow, argv[2]);
+		return 0;
+	}
+	else if(argc > 2 && strcmp(argv[1], "--record") == 0)
+	{
+		uiwindow.startRecording(argv[2]);
+	}
+
 	bool pursue = true;
 	while (pursue)
 		pursue = uiwindow.nextFrame();
+
+	uiwindow.latency().report();
 #endif
 }
@@ -0,0 +1,29 @@
+-- toyui
+-- toyui benchmarks
+
+project "benchmark"
+	kind "ConsoleApp"
+    
+	includedirs {
+		path.join(TOYOBJ_DIR, "src"),
+		path.join(TOYUI_DIR, "src"),
+		path.join(TOYUI_DIR, "benchmark"),
+	}
+
+	files {
+        path.join(TOYUI_DIR, "benchmark", "**.h"),
+        path.join(TOYUI_DIR, "benchmark", "**.cpp"),
+	}
+    
+    defines { "TOYUI_DRAW_CACHE" }
+    
+    links {
+		"toyobj",
+		"toyui",
+	}
+    
+    defines {
+        "TOYUI_RESOURCE_PATH=\"" .. path.join(TOYUI_DIR, "data") .. "/\"",
+    }
+    
+    dofile(path.join(TOYUI_DIR, "scripts/context.lua"))
@@ -21,3 +21,4 @@ dofile("../../toyobj/scripts/toytoolchain.lua")
 dofile "../../toyobj/scripts/toyobj.lua"
 dofile "toyui.lua"
 dofile "example.lua"
+dofile "benchmark.lua"
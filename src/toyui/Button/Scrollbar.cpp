@@ -13,6 +13,8 @@
 
 #include <toyobj/Iterable/Reverse.h>
 
+#include <cmath>
+
 namespace toy
 {
 	Scroller::Scroller(Wedge& parent, Dimension dim)
@@ -73,21 +75,18 @@ namespace toy
 
 	void Scrollbar::scrollup()
 	{
-		float pos = m_frameSheet.stripe().prevOffset(m_dim, -10.f);
-		this->scrollTo(std::max(0.f, d_cursor + pos));
+		this->scroll(1.f);
 	}
 
 	void Scrollbar::scrolldown()
 	{
-		float pos = m_frameSheet.stripe().nextOffset(m_dim, 10.f);
-		this->scrollTo(std::min(this->overflow(), d_cursor + pos));
+		this->scroll(-1.f);
 	}
 
 	void Scrollbar::scrollTo(float offset)
 	{
 		d_cursor = offset;
 		m_contentSheet.frame().setPositionDim(m_dim, -offset);
-		m_contentSheet.frame().layer().setForceRedraw();
 	}
 
 	void Scrollbar::scroll(float amount)
@@ -95,12 +94,20 @@ namespace toy
 		if(!this->overflow())
 			return;
 
-		if(amount > 0)
-			while(amount-- > 0)
-				this->scrollup();
-		else if(amount < 0)
-			while(amount++ < 0)
-				this->scrolldown();
+		// one item per unit, the boundary of the nth item found in a single lookup into the contents
+		int steps = amount > 0.f ? -int(std::ceil(amount)) : int(std::ceil(-amount));
+		Stripe& stripe = m_contentSheet.stripe();
+		float scale = m_contentSheet.frame().scale();
+
+		// the cursor is a scaled offset : brought back to the contents, a boundary it sits on can land just short of it, or just past it,
+		// and would count as a step, so the position snaps to the boundary first
+		float pos = d_cursor / scale;
+		float boundary = stripe.stepOffset(m_dim, pos, steps > 0 ? 1 : -1);
+		if(boundary * scale == d_cursor)
+			pos = boundary;
+
+		float offset = stripe.stepOffset(m_dim, pos, steps) * scale;
+		this->scrollTo(std::min(std::max(offset, 0.f), this->overflow()));
 	}
 
 	void Scrollbar::nextFrame(size_t tick, size_t delta)
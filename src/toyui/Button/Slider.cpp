@@ -39,7 +39,7 @@ namespace toy
 
 	void Slider::nextFrame(size_t tick, size_t delta)
 	{
-		if(m_frame->dirty() >= Frame::DIRTY_LAYOUT)
+		if(m_frame->subtreeDirty() >= Frame::DIRTY_LAYOUT)
 			this->updateKnob();
 
 		Wedge::nextFrame(tick, delta);
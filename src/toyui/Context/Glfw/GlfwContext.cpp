@@ -18,9 +18,17 @@
 
 #elif defined TOY_PLATFORM_LINUX
 	#define GLFW_EXPOSE_NATIVE_X11
+	#define GLFW_EXPOSE_NATIVE_GLX
 	#include <GLFW/glfw3native.h>
+	#include <GL/glx.h>
+
+	#ifndef GLX_BACK_BUFFER_AGE_EXT
+		#define GLX_BACK_BUFFER_AGE_EXT 0x20F4
+	#endif
 #endif
 
+#include <cstring>
+
 void errorcb(int error, const char* desc)
 {
 	printf("ERROR: GLFW %d: %s\n", error, desc);
@@ -167,6 +175,7 @@ namespace toy
 		: RenderWindow(name, width, height, 0)
 		, m_glWindow(nullptr)
 		, m_autoSwap(autoSwap)
+		, m_bufferAgeQuery(false)
 	{
 		this->initContext();
 	}
@@ -216,18 +225,42 @@ namespace toy
 #elif defined TOY_PLATFORM_WINDOWS
 		m_nativeHandle = glfwGetWin32Window(m_glWindow);
 #endif
+
+#if defined TOY_PLATFORM_LINUX
+		// partial redraws rely on the age of the back buffer to know how much of it is still valid
+		Display* display = glfwGetX11Display();
+		const char* extensions = glXQueryExtensionsString(display, DefaultScreen(display));
+		m_bufferAgeQuery = extensions && strstr(extensions, "GLX_EXT_buffer_age") != nullptr;
+#endif
 	}
 
 	bool GlfwRenderWindow::nextFrame()
 	{
 		this->resize();
 
-		if(m_autoSwap)
+		// without a swap to wait on, the loop idles until some input comes or a frame has passed
+		if(!m_present)
+			glfwWaitEventsTimeout(1.0 / 60.0);
+		else if(m_autoSwap)
 			glfwSwapBuffers(m_glWindow);
 
 		return true;
 	}
 
+	size_t GlfwRenderWindow::bufferAge()
+	{
+#if defined TOY_PLATFORM_LINUX
+		// queried on the back buffer about to be drawn, right after the previous swap
+		if(m_bufferAgeQuery)
+		{
+			unsigned int age = 0;
+			glXQueryDrawable(glfwGetX11Display(), glfwGetGLXWindow(m_glWindow), GLX_BACK_BUFFER_AGE_EXT, &age);
+			return age;
+		}
+#endif
+		return 0;
+	}
+
 	void GlfwRenderWindow::resize()
 	{
 		int winWidth, winHeight;
@@ -264,6 +297,17 @@ namespace toy
 	bool GlfwInputWindow::nextFrame()
 	{
 		glfwPollEvents();
+		this->dispatchEvents(*m_mouse, *m_keyboard);
+		return true;
+	}
+
+	bool GlfwInputWindow::sampleCursor(float& x, float& y)
+	{
+		double cursorX, cursorY;
+		glfwGetCursorPos(m_glWindow, &cursorX, &cursorY);
+
+		x = std::max(0.f, std::min(float(m_renderWindow.width()), float(cursorX)));
+		y = std::max(0.f, std::min(float(m_renderWindow.height()), float(cursorY)));
 		return true;
 	}
 
@@ -286,7 +330,7 @@ namespace toy
 		float clampedX = std::max(0.f, std::min(float(m_renderWindow.width()), m_mouseX));
 		float clampedY = std::max(0.f, std::min(float(m_renderWindow.height()), m_mouseY));
 
-		m_mouse->dispatchMouseMoved(clampedX, clampedY);
+		this->queueMouseMoved(clampedX, clampedY);
 	}
 
 	void GlfwInputWindow::injectMouseButton(int button, int action, int mods)
@@ -296,29 +340,29 @@ namespace toy
 
 		UNUSED(mods);
 		if(action == GLFW_PRESS)
-			m_mouse->dispatchMousePressed(clampedX, clampedY, convertGlfwButton(button));
+			this->queueMousePressed(clampedX, clampedY, convertGlfwButton(button));
 		else if(action == GLFW_RELEASE)
-			m_mouse->dispatchMouseReleased(clampedX, clampedY, convertGlfwButton(button));
+			this->queueMouseReleased(clampedX, clampedY, convertGlfwButton(button));
 	}
 
 	void GlfwInputWindow::injectKey(int key, int scancode, int action, int mods)
 	{
 		UNUSED(scancode); UNUSED(mods);
 		if(action == GLFW_PRESS)
-			m_keyboard->dispatchKeyPressed(convertGlfwKey(key), (char) 0);
+			this->queueKeyPressed(convertGlfwKey(key), (char) 0);
 		else if(action == GLFW_RELEASE)
-			m_keyboard->dispatchKeyReleased(convertGlfwKey(key), (char) 0);
+			this->queueKeyReleased(convertGlfwKey(key), (char) 0);
 	}
 
 	void GlfwInputWindow::injectChar(unsigned int codepoint, int mods)
 	{
 		UNUSED(codepoint); UNUSED(mods);
-		m_keyboard->dispatchKeyPressed((KeyCode) 0, (char) codepoint);
+		this->queueKeyPressed((KeyCode) 0, (char) codepoint);
 	}
 
 	void GlfwInputWindow::injectWheel(double x, double y)
 	{
-		m_mouse->dispatchMouseWheeled(m_mouseX, m_mouseY, x + y);
+		this->queueMouseWheeled(m_mouseX, m_mouseY, float(x + y));
 	}
 
 	GlfwContext::GlfwContext(RenderSystem& renderSystem, const string& name, int width, int height, bool fullScreen, bool autoSwap)
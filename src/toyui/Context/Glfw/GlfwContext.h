@@ -26,9 +26,12 @@ namespace toy
 		bool nextFrame();
 		void resize();
 
+		virtual size_t bufferAge();
+
 	protected:
 		GLFWwindow* m_glWindow;
 		bool m_autoSwap;
+		bool m_bufferAgeQuery;
 	};
 
 	class GlfwInputWindow : public InputWindow
@@ -41,6 +44,8 @@ namespace toy
 
 		bool nextFrame();
 
+		virtual bool sampleCursor(float& x, float& y);
+
 		void injectMouseMove(double x, double y);
 		void injectMouseButton(int button, int action, int mods);
 		void injectKey(int key, int scancode, int action, int mods);
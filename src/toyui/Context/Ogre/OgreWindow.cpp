@@ -106,6 +106,7 @@ namespace toy
 
 	OISInputWindow::~OISInputWindow()
 	{
+		this->setInputThread(false);
 		destroyInput();
 	}
 
@@ -136,12 +137,20 @@ namespace toy
 
 	bool OISInputWindow::nextFrame()
 	{
-		m_mouse->capture();
-		m_keyboard->capture();
+		if(!this->inputThread())
+			this->pumpInput();
+
+		this->dispatchEvents(*m_uiMouse, *m_uiKeyboard);
 
 		return !m_shutdownRequested;
 	}
 
+	void OISInputWindow::pumpInput()
+	{
+		m_mouse->capture();
+		m_keyboard->capture();
+	}
+
 	void OISInputWindow::resize(size_t width, size_t height)
 	{
 		const OIS::MouseState& mouseState = m_mouse->getMouseState();
@@ -163,10 +172,10 @@ namespace toy
 
 	bool OISInputWindow::mouseMoved(const OIS::MouseEvent &arg)
 	{
-		m_uiMouse->dispatchMouseMoved(float(arg.state.X.abs), float(arg.state.Y.abs));
+		this->queueMouseMoved(float(arg.state.X.abs), float(arg.state.Y.abs));
 
 		if(arg.state.Z.rel != 0)
-			m_uiMouse->dispatchMouseWheeled(float(arg.state.X.abs), float(arg.state.Y.abs), float(arg.state.Z.rel));
+			this->queueMouseWheeled(float(arg.state.X.abs), float(arg.state.Y.abs), float(arg.state.Z.rel));
 
 		return true;
 	}
@@ -177,7 +186,7 @@ namespace toy
 			this->mouseReleased(arg, id);
 
 		m_pressed[id] = true;
-		m_uiMouse->dispatchMousePressed(float(arg.state.X.abs), float(arg.state.Y.abs), convertOISButton(id));
+		this->queueMousePressed(float(arg.state.X.abs), float(arg.state.Y.abs), convertOISButton(id));
 		return true;
 	}
 
@@ -187,7 +196,7 @@ namespace toy
 			return true;
 
 		m_pressed[id] = false;
-		m_uiMouse->dispatchMouseReleased(float(arg.state.X.abs), float(arg.state.Y.abs), convertOISButton(id));
+		this->queueMouseReleased(float(arg.state.X.abs), float(arg.state.Y.abs), convertOISButton(id));
 		return true;
 	}
 
@@ -215,13 +224,13 @@ namespace toy
 		if(arg.key == OIS::KC_ESCAPE)
 			m_shutdownRequested = true;
 
-		m_uiKeyboard->dispatchKeyPressed(static_cast<KeyCode>(arg.key), getChar(arg));
+		this->queueKeyPressed(static_cast<KeyCode>(arg.key), getChar(arg));
 		return true;
 	}
 
 	bool OISInputWindow::keyReleased(const OIS::KeyEvent &arg)
 	{
-		m_uiKeyboard->dispatchKeyReleased(static_cast<KeyCode>(arg.key), getChar(arg));
+		this->queueKeyReleased(static_cast<KeyCode>(arg.key), getChar(arg));
 		return true;
 	}
 }
@@ -56,6 +56,9 @@ namespace toy
 		bool nextFrame();
 		void resize(size_t width, size_t height);
 
+		virtual bool threadedPump() { return true; }
+		virtual void pumpInput();
+
 		// OISInput::InputListener
 		bool mouseMoved(const OIS::MouseEvent &arg);
 		bool mousePressed(const OIS::MouseEvent &arg, OIS::MouseButtonID id);
@@ -74,7 +77,7 @@ namespace toy
 		Keyboard* m_uiKeyboard;
 
 		std::map<OIS::MouseButtonID, bool> m_pressed;
-		bool m_shutdownRequested;
+		std::atomic<bool> m_shutdownRequested;
 	};
 }
 
@@ -60,6 +60,8 @@ namespace toy
 	class Table;
 	class Layer;
 	class MasterLayer;
+	class LayoutStore;
+	class HitIndex;
 	class LayoutStyle;
 
 	enum WidgetState : unsigned int;
@@ -135,12 +137,15 @@ namespace toy
 
 	class Renderer;
 	class RenderTarget;
+	class DrawList;
 
 	class Skinner;
 	class Styler;
 
 	class RenderWindow;
 	class InputWindow;
+	class InputRecorder;
+	class InputReplay;
 	class Context;
 	class RenderSystem;
 
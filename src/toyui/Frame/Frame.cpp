@@ -15,6 +15,8 @@
 
 #include <toyui/Style/Style.h>
 
+#include <toyui/Input/InputLatency.h>
+
 #include <cmath>
 
 namespace toy
@@ -22,14 +24,27 @@ namespace toy
 	float AlignSpace[5] = { 0.f, 0.5f, 1.f, 0.f, 1.f };
 	float AlignExtent[5] = { 0.f, 0.5f, 1.f, 1.f, 0.f };
 
+	static thread_local Frame* t_dirtyBarrier = nullptr;
+
 	Frame::Frame(Widget& widget)
 		: Uibox()
 		, d_widget(&widget)
 		, d_frame(*this)
 		, d_parent(nullptr)
 		, d_dirty(DIRTY_MAPPING)
+		, d_descendantDirty(CLEAN)
+		, d_contentStamp(1)
+		, d_layoutStyleStamp(1)
+		, d_measureKey{ 0.f, 0.f, 0, 0 }
+		, d_resizeKey{ 0.f, 0.f, 0, 0 }
+		, d_kernel(0)
 		, d_hidden(false)
 		, d_index(0, 0)
+		, d_absoluteOrigin(0.f, 0.f)
+		, d_absoluteFactor(1.f)
+		, d_absoluteScale(1.f)
+		, d_absoluteValid(false)
+		, d_drawnRect()
 		, d_hardClip()
 	{}
 
@@ -39,8 +54,18 @@ namespace toy
 		, d_frame(*this)
 		, d_parent(nullptr)
 		, d_dirty(DIRTY_MAPPING)
+		, d_descendantDirty(CLEAN)
+		, d_contentStamp(1)
+		, d_layoutStyleStamp(1)
+		, d_measureKey{ 0.f, 0.f, 0, 0 }
+		, d_resizeKey{ 0.f, 0.f, 0, 0 }
+		, d_kernel(0)
 		, d_hidden(false)
 		, d_index(0, 0)
+		, d_absoluteOrigin(0.f, 0.f)
+		, d_absoluteFactor(1.f)
+		, d_absoluteScale(1.f)
+		, d_absoluteValid(false)
 	{
 		this->setStyle(style);
 		parent.append(*this);
@@ -70,15 +95,48 @@ namespace toy
 
 	void Frame::markDirty(Dirty dirty)
 	{
-		this->setDirty(dirty);
-		Stripe* parent = this->parent();
-		while(parent)
+		if(dirty > d_dirty)
+			d_dirty = dirty;
+
+		InputLatency::invalidated();
+
+		// a layout dirty only means the geometry changed, which the layout keys already account for
+		if(dirty >= DIRTY_CONTENT && dirty != DIRTY_LAYOUT)
+			++d_contentStamp;
+
+		if(dirty == DIRTY_ABSOLUTE)
+			this->invalidateAbsolute();
+
+		if(d_parent)
+			d_parent->markDescendantDirty(dirty);
+	}
+
+	void Frame::markDescendantDirty(Dirty dirty)
+	{
+		// ancestors of a dirty descendant are always at least as dirty, so we can stop early
+		Frame* barrier = t_dirtyBarrier;
+		Frame* frame = this;
+		while(frame && frame->d_descendantDirty < dirty)
 		{
-			parent->setDirty(dirty);
-			parent = parent->parent();
+			frame->d_descendantDirty = dirty;
+			if(frame == barrier)
+				break;
+			frame = frame->d_parent;
 		}
 	}
 
+	void Frame::propagateDirty()
+	{
+		if(d_parent && this->subtreeDirty() > CLEAN)
+			d_parent->markDescendantDirty(this->subtreeDirty());
+	}
+
+	void Frame::setDirtyBarrier(Frame* frame)
+	{
+		// frames laid out on a worker thread don't propagate past the root of their job
+		t_dirtyBarrier = frame;
+	}
+
 	void Frame::setStyle(Style& style, bool reset)
 	{
 		d_style = &style;
@@ -88,6 +146,8 @@ namespace toy
 	void Frame::updateStyle()
 	{
 		d_styleStamp = d_style->updated();
+		// padding, spacing or margins may change without the frame size changing : the layout keys must not match anymore
+		++d_layoutStyleStamp;
 		d_opacity = d_style->layout().opacity();
 
 		if(d_widget)
@@ -95,14 +155,28 @@ namespace toy
 		else
 			d_frame.resetInkstyle(d_style->skin());
 
+		// the layout parameters come from the style : the frame is laid out again, and read again by a layout store
 		if(d_parent)
+		{
 			this->updateLayout();
+			this->markDirty(DIRTY_LAYOUT);
+		}
 	}
 
 	void Frame::resetStyle()
 	{
 		this->updateStyle();
 		this->markDirty(DIRTY_MAPPING);
+
+		// the stripe that maps this frame must remap it according to its new flow
+		Stripe* owner = d_parent;
+		while(owner && !owner->widget())
+			owner = owner->parent();
+
+		if(owner && d_widget)
+			owner->markRemap(*this);
+		else if(owner)
+			owner->markDirty(DIRTY_MAPPING);
 	}
 
 	void Frame::updateLayout()
@@ -134,6 +208,8 @@ namespace toy
 
 		this->updateFixed(DIM_X);
 		this->updateFixed(DIM_Y);
+
+		this->updateKernel();
 	}
 
 	void Frame::applySpace(Direction direction, Sizing length, Sizing depth)
@@ -156,6 +232,13 @@ namespace toy
 		d_sizing[d_depth] = depth;
 	}
 
+	void Frame::updateKernel()
+	{
+		// index in the stripe layout kernels, without the flow : fixed and manual sizing share a kernel
+		auto sizing = [this](Dimension dim) { return d_sizing[dim] <= MANUAL ? 0 : d_sizing[dim] - 1; };
+		d_kernel = (sizing(DIM_X) * 4 + sizing(DIM_Y)) * 4;
+	}
+
 	void Frame::updateFixed(Dimension dim)
 	{
 		if(d_style->layout().size()[dim])
@@ -165,20 +248,32 @@ namespace toy
 	void Frame::setFixedSize(Dimension dim, float size)
 	{
 		d_sizing[dim] = FIXED;
+		this->updateKernel();
 		d_content[dim] = size;
 		if(d_style->layout().d_space != BOARD || d_size[dim] == 0.f)
 			this->setSizeDim(dim, size);
+		this->markDirty(DIRTY_LAYOUT);
 	}
 
 	void Frame::bind(Stripe& parent)
 	{
 		d_parent = &parent;
+		this->invalidateAbsolute();
 		this->updateLayout();
+
+		this->propagateDirty();
+
+		if(this->frameType() >= LAYER)
+			d_parent->layer().markSublayers();
 	}
 	
 	void Frame::unbind()
 	{
+		if(d_parent && this->frameType() >= LAYER)
+			d_parent->layer().markSublayers();
+
 		d_parent = nullptr;
+		this->invalidateAbsolute();
 	}
 
 	void Frame::remap()
@@ -216,21 +311,28 @@ namespace toy
 
 	void Frame::setPositionDim(Dimension dim, float position)
 	{
+		if(d_position[dim] == position)
+			return;
+
 		d_position[dim] = position;
 		//this->markDirty(DIRTY_LAYOUT);
-		this->setDirty(DIRTY_ABSOLUTE);
+		this->markDirty(DIRTY_ABSOLUTE);
 	}
 
 	void Frame::show()
 	{
 		d_hidden = false;
 		this->markDirty(DIRTY_LAYOUT);
+		if(d_parent)
+			d_parent->resetIndex();
 	}
 
 	void Frame::hide()
 	{
 		d_hidden = true;
 		this->markDirty(DIRTY_LAYOUT);
+		if(d_parent)
+			d_parent->resetIndex();
 	}
 
 	bool Frame::visible()
@@ -282,21 +384,96 @@ namespace toy
 		return pos;
 	}
 
+	void Frame::invalidateAbsolute()
+	{
+		// the subtree below an invalid frame is already invalid
+		if(!d_absoluteValid)
+			return;
+
+		d_absoluteValid = false;
+		if(this->frameType() >= STRIPE)
+			for(Frame* frame : this->as<Stripe>().contents())
+				frame->invalidateAbsolute();
+	}
+
+	void Frame::updateAbsolute()
+	{
+		if(d_absoluteValid)
+			return;
+
+		if(this->frameType() >= MASTER_LAYER || !d_parent)
+		{
+			d_absoluteOrigin = DimFloat(0.f, 0.f);
+			d_absoluteFactor = 1.f;
+			d_absoluteScale = d_scale;
+		}
+		else
+		{
+			// same steps as derivePosition and deriveScale, one level at a time
+			d_parent->updateAbsolute();
+			d_absoluteOrigin = d_parent->d_absoluteOrigin;
+			d_absoluteFactor = d_parent->d_absoluteFactor;
+			d_absoluteScale = d_parent->d_absoluteScale * d_scale;
+
+			if(d_widget)
+			{
+				d_absoluteOrigin[DIM_X] += d_position[DIM_X] * d_absoluteFactor;
+				d_absoluteOrigin[DIM_Y] += d_position[DIM_Y] * d_absoluteFactor;
+				d_absoluteFactor *= d_scale;
+			}
+		}
+
+		d_absoluteValid = true;
+	}
+
 	DimFloat Frame::absolutePosition()
 	{
-		return this->relativePosition(this->masterlayer());
+		this->updateAbsolute();
+		return d_absoluteOrigin;
+	}
+
+	BoxFloat Frame::absoluteRect()
+	{
+		this->updateAbsolute();
+
+		// the origin of a frame without a widget doesn't account for its own position, which is passed on to its contents instead
+		float x = d_absoluteOrigin[DIM_X] + (d_widget ? 0.f : d_position[DIM_X] * d_absoluteFactor);
+		float y = d_absoluteOrigin[DIM_Y] + (d_widget ? 0.f : d_position[DIM_Y] * d_absoluteFactor);
+		return BoxFloat(x, y, d_size[DIM_X] * d_absoluteScale, d_size[DIM_Y] * d_absoluteScale);
+	}
+
+	BoxFloat Frame::drawnRect()
+	{
+		if(d_drawnRect.null() || !d_parent)
+			return d_drawnRect;
+
+		DimFloat origin = d_parent->absolutePosition();
+		return BoxFloat(origin[DIM_X] + d_drawnRect.x(), origin[DIM_Y] + d_drawnRect.y(), d_drawnRect.w(), d_drawnRect.h());
+	}
+
+	void Frame::updateDrawnRect()
+	{
+		if(d_hidden)
+		{
+			d_drawnRect = BoxFloat();
+			return;
+		}
+
+		BoxFloat rect = this->absoluteRect();
+		DimFloat origin = d_parent ? d_parent->absolutePosition() : DimFloat(0.f, 0.f);
+		d_drawnRect.assign(rect.x() - origin[DIM_X], rect.y() - origin[DIM_Y], rect.w(), rect.h());
 	}
 
 	float Frame::absoluteScale()
 	{
-		return this->deriveScale(this->masterlayer());
+		this->updateAbsolute();
+		return d_absoluteScale;
 	}
 
 	DimFloat Frame::localPosition(float x, float y)
 	{
-		DimFloat local(x, y);
-		this->integratePosition(this->masterlayer(), local);
-		return local;
+		this->updateAbsolute();
+		return DimFloat((x - d_absoluteOrigin[DIM_X]) / d_absoluteFactor, (y - d_absoluteOrigin[DIM_Y]) / d_absoluteFactor);
 	}
 
 	float Frame::doffset(Dimension dim)
@@ -23,9 +23,21 @@ namespace toy
 		Frame(Widget& widget);
 		Frame(Style& style, Stripe& parent);
 
+		// constraints, style and contents a frame was last laid out with
+		struct LayoutKey
+		{
+			float width;
+			float height;
+			size_t styleStamp;
+			size_t contentStamp;
+
+			bool operator==(const LayoutKey& other) const { return width == other.width && height == other.height && styleStamp == other.styleStamp && contentStamp == other.contentStamp; }
+		};
+
 		enum Dirty
 		{
 			CLEAN,				// Frame doesn't need update
+			DIRTY_PAINT,		// The frame needs to be redrawn, its metrics are unchanged
 			DIRTY_ABSOLUTE,		// The absolute position of the frame has changed
 			DIRTY_POSITION,		// The relative position of the frame has changed
 			DIRTY_CONTENT,		// The content of the widget has changed
@@ -40,6 +52,11 @@ namespace toy
 		inline DrawFrame& content() { return d_frame; }
 		inline Stripe* parent() { return d_parent; }
 		inline Dirty dirty() { return d_dirty; }
+		inline Dirty descendantDirty() { return d_descendantDirty; }
+		inline Dirty subtreeDirty() { return d_dirty > d_descendantDirty ? d_dirty : d_descendantDirty; }
+		inline size_t contentStamp() { return d_contentStamp; }
+		// the flow is read from the live style, it may change without the style being applied again
+		inline size_t kernel() { return d_kernel + d_style->layout().d_flow; }
 		inline bool hidden() { return d_hidden; }
 		inline const Index& index() { return d_index; }
 		inline size_t dindex(Dimension dim) { return d_index[dim]; }
@@ -70,9 +87,19 @@ namespace toy
 
 		bool visible();
 
-		void clearDirty() { d_dirty = CLEAN; }
-		void setDirty(Dirty dirty) { if(dirty > d_dirty) d_dirty = dirty; }
+		void clearDirty() { d_dirty = CLEAN; d_descendantDirty = CLEAN; }
 		void markDirty(Dirty dirty);
+		void propagateDirty();
+		void invalidateAbsolute();
+
+		// with clean descendants, measuring or resizing again with the same key yields the same layout
+		LayoutKey layoutKey() { return { d_size[DIM_X], d_size[DIM_Y], d_layoutStyleStamp, d_contentStamp }; }
+		bool measureCached() { return d_descendantDirty < DIRTY_CONTENT && d_measureKey == this->layoutKey(); }
+		bool resizeCached() { return d_descendantDirty < DIRTY_CONTENT && d_resizeKey == this->layoutKey(); }
+		void cacheMeasure() { d_measureKey = this->layoutKey(); }
+		void cacheResize() { d_resizeKey = this->layoutKey(); }
+
+		static void setDirtyBarrier(Frame* frame);
 
 		virtual Frame* pinpoint(float x, float y, const Filter& filter = nullptr);
 
@@ -82,6 +109,7 @@ namespace toy
 		void updateLayout();
 
 		void applySpace(Direction direction, Sizing length, Sizing depth);
+		void updateKernel();
 
 		void setStyle(Style& style, bool reset = false);
 		void updateStyle();
@@ -110,6 +138,12 @@ namespace toy
 		DimFloat absolutePosition();
 		float absoluteScale();
 
+		// area of the master layer the frame covers, and the one it covered when damage was last gathered
+		// the latter is kept relative to the parent, so that it follows the moves of the ancestors
+		BoxFloat absoluteRect();
+		BoxFloat drawnRect();
+		void updateDrawnRect();
+
 		DimFloat relativePosition(Frame& root);
 		DimFloat localPosition(float x, float y);
 
@@ -123,14 +157,32 @@ namespace toy
 
 		static Type& cls() { static Type ty; return ty; }
 
+	protected:
+		void markDescendantDirty(Dirty dirty);
+		void updateAbsolute();
+
 	protected:
 		Widget* d_widget;
 		DrawFrame d_frame;
 		Stripe* d_parent;
 		Dirty d_dirty;
+		Dirty d_descendantDirty;
+		size_t d_contentStamp;
+		size_t d_layoutStyleStamp;
+		LayoutKey d_measureKey;
+		LayoutKey d_resizeKey;
+		size_t d_kernel;
 		bool d_hidden;
 		Index d_index;
 
+		// transform from the local space of the frame to its master layer : a valid transform implies valid ones up to the root,
+		// so an invalid frame has an invalid subtree, and moving a frame only invalidates its subtree
+		DimFloat d_absoluteOrigin;
+		float d_absoluteFactor;
+		float d_absoluteScale;
+		bool d_absoluteValid;
+
+		BoxFloat d_drawnRect;
 		BoxFloat d_hardClip;
 	};
 }
@@ -36,9 +36,12 @@ namespace toy
 
 	void TableGrid::remap()
 	{
-		if(d_dirty < DIRTY_MAPPING)
+		if(this->subtreeDirty() < DIRTY_MAPPING && d_remaps.empty())
 			return;
 
+		// columns gather the cells of every row, so any remapping below invalidates them
+		this->markDirty(DIRTY_MAPPING);
+
 		Stripe::remap();
 
 		for(Frame* pframe : d_sequence)
@@ -85,6 +88,7 @@ namespace toy
 	void Grid::unmap(Frame& frame)
 	{
 		size_t line = frame.dindex(d_length);
+		frame.unbind();
 		d_lines[line]->remove(frame);
 	}
 	
@@ -0,0 +1,289 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Frame/HitIndex.h>
+
+#include <toyui/Frame/Layer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+namespace toy
+{
+	HitIndex::HitIndex(Layer& layer)
+		: d_layer(layer)
+		, d_rebuild(true)
+		, d_origin{ 0.f, 0.f }
+		, d_cellSize{ 1.f, 1.f }
+		, d_cellCount{ 1, 1 }
+	{}
+
+	bool HitIndex::indexed(Frame& frame)
+	{
+		this->update();
+		return d_lookup.find(&frame) != d_lookup.end();
+	}
+
+	void HitIndex::update()
+	{
+		if(!d_rebuild && d_moved.size() > d_entries.size() / 8)
+			d_rebuild = true;
+
+		if(d_rebuild)
+		{
+			this->rebuild();
+			d_rebuild = false;
+			d_moved.clear();
+			return;
+		}
+
+		std::vector<size_t> moved;
+		for(Frame* frame : d_moved)
+		{
+			auto it = d_lookup.find(frame);
+			if(it != d_lookup.end())
+				moved.push_back(it->second);
+		}
+
+		d_moved.clear();
+		std::sort(moved.begin(), moved.end());
+
+		// a moved frame moves its whole subtree, which is the range of entries following it
+		size_t done = 0;
+		for(size_t index : moved)
+		{
+			if(index < done)
+				continue;
+
+			for(size_t i = index; i < d_entries[index].end; ++i)
+			{
+				this->removeCells(i);
+				this->place(i);
+				this->addCells(i);
+			}
+
+			done = d_entries[index].end;
+		}
+	}
+
+	void HitIndex::rebuild()
+	{
+		d_entries.clear();
+		d_lookup.clear();
+		d_sublayers.clear();
+
+		this->gather(d_layer, -1);
+
+		float bounds[4] = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for(size_t i = 0; i < d_entries.size(); ++i)
+			if(this->celled(i))
+			{
+				bounds[0] = std::min(bounds[0], d_entries[i].box[0]);
+				bounds[1] = std::min(bounds[1], d_entries[i].box[1]);
+				bounds[2] = std::max(bounds[2], d_entries[i].box[2]);
+				bounds[3] = std::max(bounds[3], d_entries[i].box[3]);
+			}
+
+		if(bounds[0] > bounds[2])
+		{
+			bounds[0] = bounds[1] = 0.f;
+			bounds[2] = bounds[3] = 1.f;
+		}
+
+		// cells hold a few entries each on average
+		float width = std::max(1.f, bounds[2] - bounds[0]);
+		float height = std::max(1.f, bounds[3] - bounds[1]);
+		float cells = std::max(1.f, float(d_entries.size()) / 4.f);
+		float side = std::sqrt(width * height / cells);
+
+		d_origin[DIM_X] = bounds[0];
+		d_origin[DIM_Y] = bounds[1];
+		d_cellCount[DIM_X] = std::max(1, std::min(256, int(width / side)));
+		d_cellCount[DIM_Y] = std::max(1, std::min(256, int(height / side)));
+		d_cellSize[DIM_X] = width / d_cellCount[DIM_X];
+		d_cellSize[DIM_Y] = height / d_cellCount[DIM_Y];
+
+		d_cells.clear();
+		d_cells.resize(d_cellCount[DIM_X] * d_cellCount[DIM_Y]);
+
+		for(size_t i = 0; i < d_entries.size(); ++i)
+			this->addCells(i);
+	}
+
+	void HitIndex::gather(Frame& frame, int parent)
+	{
+		size_t index = d_entries.size();
+		d_entries.push_back(Entry());
+		d_entries[index].frame = &frame;
+		d_entries[index].parent = parent;
+		d_lookup[&frame] = index;
+
+		this->place(index);
+
+		// sublayers index their own frames
+		if(parent >= 0 && frame.frameType() >= LAYER)
+			d_sublayers.push_back(index);
+		else if(frame.frameType() >= STRIPE)
+			for(Frame* child : frame.as<Stripe>().contents())
+				this->gather(*child, int(index));
+
+		d_entries[index].end = d_entries.size();
+	}
+
+	void HitIndex::place(size_t index)
+	{
+		Entry& entry = d_entries[index];
+		Frame& frame = *entry.frame;
+
+		if(entry.parent < 0)
+		{
+			entry.x = 0.f;
+			entry.y = 0.f;
+			entry.scale = 1.f;
+		}
+		else
+		{
+			// same transforms as Stripe::pinpoint : children of a frame without a widget are placed relative to the closest frame with one
+			Entry& above = d_entries[entry.parent];
+			Frame& stripe = *above.frame;
+			float x = stripe.widget() ? above.x : above.x - above.scale * stripe.left();
+			float y = stripe.widget() ? above.y : above.y - above.scale * stripe.top();
+
+			entry.x = x + above.scale * frame.left();
+			entry.y = y + above.scale * frame.top();
+			entry.scale = above.scale * frame.scale();
+		}
+
+		entry.box[0] = entry.x;
+		entry.box[1] = entry.y;
+		entry.box[2] = entry.x + entry.scale * frame.width();
+		entry.box[3] = entry.y + entry.scale * frame.height();
+	}
+
+	bool HitIndex::celled(size_t index)
+	{
+		// the layer itself is never a candidate, and sublayers are always tried
+		return index > 0 && d_entries[index].frame->frameType() < LAYER;
+	}
+
+	int HitIndex::cell(int dim, float value)
+	{
+		float cell = std::floor((value - d_origin[dim]) / d_cellSize[dim]);
+		if(!(cell >= 0.f))
+			return 0;
+		return std::min(d_cellCount[dim] - 1, int(std::min(cell, float(d_cellCount[dim]))));
+	}
+
+	void HitIndex::addCells(size_t index)
+	{
+		if(!this->celled(index))
+			return;
+
+		Entry& entry = d_entries[index];
+		entry.cells[0] = this->cell(DIM_X, entry.box[0]);
+		entry.cells[1] = this->cell(DIM_Y, entry.box[1]);
+		entry.cells[2] = this->cell(DIM_X, entry.box[2]);
+		entry.cells[3] = this->cell(DIM_Y, entry.box[3]);
+
+		for(int y = entry.cells[1]; y <= entry.cells[3]; ++y)
+			for(int x = entry.cells[0]; x <= entry.cells[2]; ++x)
+				d_cells[y * d_cellCount[DIM_X] + x].push_back(index);
+	}
+
+	void HitIndex::removeCells(size_t index)
+	{
+		if(!this->celled(index))
+			return;
+
+		Entry& entry = d_entries[index];
+		for(int y = entry.cells[1]; y <= entry.cells[3]; ++y)
+			for(int x = entry.cells[0]; x <= entry.cells[2]; ++x)
+			{
+				std::vector<size_t>& cell = d_cells[y * d_cellCount[DIM_X] + x];
+				auto it = std::find(cell.begin(), cell.end(), index);
+				if(it == cell.end())
+					continue;
+				*it = cell.back();
+				cell.pop_back();
+			}
+	}
+
+	bool HitIndex::hit(size_t index, float x, float y)
+	{
+		const float* box = d_entries[index].box;
+		return x >= box[0] && x <= box[2] && y >= box[1] && y <= box[3];
+	}
+
+	bool HitIndex::reaches(size_t index, size_t root, float x, float y)
+	{
+		// the point must get through each ancestor down from root, like a pinpoint descending the tree
+		for(int above = d_entries[index].parent; above >= 0 && size_t(above) != root; above = d_entries[above].parent)
+		{
+			Frame& frame = *d_entries[above].frame;
+			if(frame.hidden() || frame.hollow() || (frame.clip() && !this->hit(above, x, y)))
+				return false;
+		}
+		return true;
+	}
+
+	Frame* HitIndex::pinpoint(Stripe& root, float x, float y, const Frame::Filter& filter, bool sublayers)
+	{
+		this->update();
+
+		size_t top = d_lookup[&root];
+		Entry& base = d_entries[top];
+		float lx = base.x + x * base.scale;
+		float ly = base.y + y * base.scale;
+
+		d_candidates.clear();
+
+		for(size_t index : d_cells[this->cell(DIM_Y, ly) * d_cellCount[DIM_X] + this->cell(DIM_X, lx)])
+			if(index > top && index < base.end && this->hit(index, lx, ly))
+				d_candidates.push_back(index);
+
+		if(sublayers)
+			for(size_t index : d_sublayers)
+				if(index > top && index < base.end)
+					d_candidates.push_back(index);
+
+		// the last frame in pre-order is the first one a pinpoint would find
+		std::sort(d_candidates.begin(), d_candidates.end(), [](size_t a, size_t b) { return a > b; });
+
+		for(size_t index : d_candidates)
+		{
+			if(!this->reaches(index, top, lx, ly))
+				continue;
+
+			Entry& entry = d_entries[index];
+			Frame& frame = *entry.frame;
+			float fx = (lx - entry.x) / entry.scale;
+			float fy = (ly - entry.y) / entry.scale;
+
+			if(frame.frameType() >= LAYER)
+			{
+				Frame* target = frame.pinpoint(fx, fy, filter);
+				if(target)
+					return target;
+			}
+			else if(!(frame.frameType() >= STRIPE && frame.hollow()) && filter(frame) && !frame.hidden() && frame.inside(fx, fy))
+			{
+				return &frame;
+			}
+		}
+
+		return nullptr;
+	}
+
+	DimFloat HitIndex::localPosition(Layer& sublayer, float x, float y)
+	{
+		auto it = d_lookup.find(&sublayer);
+		if(it == d_lookup.end())
+			return sublayer.localPosition(x, y);
+
+		Entry& entry = d_entries[it->second];
+		return DimFloat((x - entry.x) / entry.scale, (y - entry.y) / entry.scale);
+	}
+}
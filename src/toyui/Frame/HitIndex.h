@@ -0,0 +1,82 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_HITINDEX_H
+#define TOY_HITINDEX_H
+
+/* toy */
+#include <toyui/Forward.h>
+#include <toyui/Frame/Frame.h>
+
+/* Standards */
+#include <vector>
+#include <unordered_map>
+
+namespace toy
+{
+	/* Uniform grid over the frames of a layer, sublayers excluded, holding their boxes in layer coordinates.
+	   Entries are numbered in pre-order, so that the frame a pinpoint would find first is the candidate with the highest order :
+	   the grid only narrows down the candidates, hidden, hollow, clip and filter are checked on the frames themselves. */
+	class TOY_UI_EXPORT HitIndex
+	{
+	public:
+		HitIndex(Layer& layer);
+
+		size_t size() { return d_entries.size(); }
+
+		// frames whose structure changed call for a rebuild, moved frames only update their subtree
+		void markRebuild() { d_rebuild = true; d_moved.clear(); }
+		void markMoved(Frame& frame) { if(!d_rebuild) d_moved.push_back(&frame); }
+
+		bool indexed(Frame& frame);
+
+		// finds the frame under a point local to root, among the descendants of root
+		Frame* pinpoint(Stripe& root, float x, float y, const Frame::Filter& filter, bool sublayers);
+
+		// point local to a sublayer, from a point local to the layer
+		DimFloat localPosition(Layer& sublayer, float x, float y);
+
+	protected:
+		struct Entry
+		{
+			Frame* frame;
+			int parent;
+			size_t end;
+			float x, y, scale;
+			float box[4];
+			int cells[4];
+		};
+
+		void update();
+		void rebuild();
+		void gather(Frame& frame, int parent);
+		void place(size_t index);
+
+		bool celled(size_t index);
+		void addCells(size_t index);
+		void removeCells(size_t index);
+		int cell(int dim, float value);
+
+		bool hit(size_t index, float x, float y);
+		bool reaches(size_t index, size_t root, float x, float y);
+
+	protected:
+		Layer& d_layer;
+		bool d_rebuild;
+		std::vector<Frame*> d_moved;
+
+		std::vector<Entry> d_entries;
+		std::unordered_map<Frame*, size_t> d_lookup;
+		std::vector<size_t> d_sublayers;
+
+		float d_origin[2];
+		float d_cellSize[2];
+		int d_cellCount[2];
+		std::vector<std::vector<size_t>> d_cells;
+
+		std::vector<size_t> d_candidates;
+	};
+}
+
+#endif // TOY_HITINDEX_H
@@ -5,10 +5,14 @@
 
 #include <toyui/Config.h>
 #include <toyui/Frame/Layer.h>
+#include <toyui/Frame/LayoutStore.h>
+#include <toyui/Frame/LayoutPool.h>
+#include <toyui/Frame/HitIndex.h>
 
 #include <toyobj/Iterable/Reverse.h>
 
 #include <toyui/Widget/Widget.h>
+#include <toyui/Widget/Sheet.h>
 #include <toyui/Render/Renderer.h>
 
 #include <toyui/UiWindow.h>
@@ -17,17 +21,27 @@
 
 namespace toy
 {
+	bool Layer::s_hitIndex = true;
+
 	Layer::Layer(Widget& widget)
 		: Stripe(widget)
 		, d_parentLayer(nullptr)
 		, d_index(-1)
 		, d_z(0)
 		, d_redraw(REDRAW)
+		, d_cacheable(false)
+		, d_sublayersDirty(true)
 	{}
 
 	Layer::~Layer()
 	{}
 
+	void Layer::setCacheable(bool cacheable)
+	{
+		d_cacheable = cacheable;
+		this->markDirty(DIRTY_PAINT);
+	}
+
 	void Layer::collectLayers(std::vector<Layer*>& layers, FrameType barrier)
 	{
 		layers.clear();
@@ -46,6 +60,9 @@ namespace toy
 
 		Stripe::remap();
 
+		if(!d_sublayersDirty)
+			return;
+
 		this->collectLayers(d_sublayers);
 
 		auto goesBefore = [](Layer* a, Layer* b) { return a->index() < b->index(); };
@@ -53,6 +70,8 @@ namespace toy
 
 		this->reindex(0);
 
+		d_sublayersDirty = false;
+		this->masterlayer().markReorder();
 	}
 
 	void Layer::reindex(size_t from)
@@ -80,9 +99,17 @@ namespace toy
 		if(!this->visible() || this->hollow() || (this->clip() && !this->inside(x, y)))
 			return nullptr;
 
+		// geometry changed since the last redraw isn't indexed yet
+		bool indexed = s_hitIndex && this->subtreeDirty() < DIRTY_ABSOLUTE;
+
 		for(Layer* frame : reverse_adapt(d_sublayers))
 		{
-			DimFloat local = frame->localPosition(x, y); // probably should be local to this
+			DimFloat local(x, y);
+			if(indexed)
+				local = this->hitIndex().localPosition(*frame, x, y);
+			else
+				frame->integratePosition(*this, local);
+
 			Frame* target = frame->pinpoint(local.x(), local.y(), filter);
 			if(target)
 				return target;
@@ -91,32 +118,230 @@ namespace toy
 		return Stripe::pinpoint(x, y, filter);
 	}
 
+	HitIndex& Layer::hitIndex()
+	{
+		if(!d_hitIndex)
+			d_hitIndex = make_unique<HitIndex>(*this);
+		return *d_hitIndex;
+	}
+
+	void Layer::markHitRebuild()
+	{
+		if(d_hitIndex)
+			d_hitIndex->markRebuild();
+	}
+
+	void Layer::markHitMoved(Frame& frame)
+	{
+		if(d_hitIndex)
+			d_hitIndex->markMoved(frame);
+	}
+
 	MasterLayer::MasterLayer(Widget& widget)
 		: Layer(widget)
+		, d_reorder(false)
+		, d_cacheLayers(false)
+		, d_layoutVisits(0)
+		, d_poolVisits(0)
+		, d_layoutBudget(0.f)
+		, d_damage()
+		, d_damagedFrames(0)
+	{}
+
+	MasterLayer::~MasterLayer()
 	{}
 
+	void MasterLayer::setCacheLayers(bool cached)
+	{
+		d_cacheLayers = cached;
+		for(Layer* layer : d_layers)
+			layer->setCacheable(cached);
+	}
+
+	void MasterLayer::setLayoutStore(bool enabled)
+	{
+		if(enabled && !d_layoutStore)
+			d_layoutStore = make_unique<LayoutStore>();
+		else if(!enabled && d_layoutStore)
+		{
+			// a pass left halfway is done over by the stripe passes
+			if(d_layoutStore->pending())
+				this->visit([](Frame& frame) { frame.markDirty(DIRTY_CONTENT); return true; });
+			d_layoutStore = nullptr;
+		}
+	}
+
+	size_t MasterLayer::layoutLoaded()
+	{
+		return d_layoutStore ? d_layoutStore->loaded() : 0;
+	}
+
+	size_t MasterLayer::layoutStored()
+	{
+		return d_layoutStore ? d_layoutStore->stored() : 0;
+	}
+
+	void MasterLayer::setLayoutBudget(float milliseconds)
+	{
+		d_layoutBudget = milliseconds;
+		if(milliseconds > 0.f)
+			this->setLayoutStore(true);
+	}
+
+	bool MasterLayer::layoutPending()
+	{
+		return d_layoutStore && d_layoutStore->pending();
+	}
+
+	void MasterLayer::setLayoutThreads(size_t workers)
+	{
+		if(workers != this->layoutThreads())
+			d_layoutPool = workers ? make_unique<LayoutPool>(workers) : nullptr;
+	}
+
 	void MasterLayer::relayout()
 	{
+		size_t& visits = Stripe::layoutVisits();
+		visits = 0;
+		d_poolVisits = 0;
+
 		this->remap();
 
-		if(d_dirty >= DIRTY_STRUCTURE || d_reorder)
+		if(d_reorder)
 			this->reorder();
 
+		if(d_layoutStore)
+		{
+			// the dirty state left by an unfinished pass is consumed right away, so the next slice only sees new changes
+			if(!d_layoutStore->relayout(*this, d_layoutBudget))
+				this->redraw();
+		}
+		else if(d_layoutPool && d_sublayers.size() > 0 && this->subtreeDirty() >= DIRTY_CONTENT)
+		{
+			this->relayoutParallel();
+		}
+		else
+		{
+			this->measureLayout();
+			this->resizeLayout();
+			this->positionLayout();
+		}
+
+		d_layoutVisits = visits + d_poolVisits;
+	}
+
+	void MasterLayer::relayoutParallel()
+	{
+		// a sublayer measures independently of its parent, and once its parent has sized and placed it, its own passes only touch its subtree :
+		// each pass of the master skips over the sublayers, which are then processed as independent jobs
+		FrameVector layers;
+		for(Layer* layer : d_sublayers)
+			if(layer->subtreeDirty() >= DIRTY_CONTENT)
+				layers.push_back(layer);
+
+		this->dispatchLayers(layers, &Frame::measureLayout);
+
+		layers.clear();
+		deferSublayers(this, &layers);
 		this->measureLayout();
 		this->resizeLayout();
+		deferSublayers(nullptr, nullptr);
+
+		this->dispatchLayers(layers, &Frame::resizeLayout);
+
+		layers.clear();
+		deferSublayers(this, &layers);
 		this->positionLayout();
+		deferSublayers(nullptr, nullptr);
+
+		this->dispatchLayers(layers, &Frame::positionLayout);
+	}
+
+	void MasterLayer::dispatchLayers(const FrameVector& layers, void (Frame::*pass)())
+	{
+		d_layoutPool->dispatch(layers.size(), [this, &layers, pass](size_t index) {
+			Frame& layer = *layers[index];
+			size_t& visits = Stripe::layoutVisits();
+			size_t start = visits;
+
+			setDirtyBarrier(&layer);
+			(layer.*pass)();
+			setDirtyBarrier(nullptr);
+
+			d_poolVisits += visits - start;
+			visits = start;
+		});
+
+		// dirty flags merge by maximum, so propagating them after the jobs gives the same state as the serial passes
+		for(Frame* layer : layers)
+			layer->propagateDirty();
+	}
+
+	static bool culledMove(Frame& frame)
+	{
+		Wedge* parent = frame.widget() ? frame.widget()->parent() : nullptr;
+		return frame.content().culled() || (parent && parent->frame().content().culledContents());
 	}
 
 	void MasterLayer::redraw()
 	{
-		this->visit([](Frame& frame) {
+		this->visit([this](Frame& frame) {
 			if(frame.dirty())
-				frame.layer().setRedraw();
+			{
+				// a frame that only moved is replayed at its new place along with its subtree, nothing is recorded again :
+				// a layer that moved as a whole doesn't even change within itself, and a cached one keeps its texture
+				// culled frames are missing from the segments though, so moving them or their parents gathers them again
+				if(frame.dirty() != DIRTY_ABSOLUTE || (frame.frameType() != LAYER && culledMove(frame)))
+					frame.layer().setRedraw();
+				else if(frame.frameType() != LAYER)
+					frame.layer().setReplay();
+				this->damageFrame(frame);
+			}
+			if(frame.dirty() >= DIRTY_STRUCTURE)
+				frame.layer().markHitRebuild();
+			// a layer is placed in the hit index of its parent layer
+			Layer* indexing = frame.frameType() >= LAYER ? frame.as<Layer>().parentLayer() : &frame.layer();
+			if(frame.dirty() >= DIRTY_ABSOLUTE && indexing)
+				indexing->markHitMoved(frame);
+			bool pursue = frame.descendantDirty() > CLEAN;
 			frame.clearDirty();
-			return true;
+			return pursue;
 		});
 	}
 
+	void MasterLayer::damageFrame(Frame& frame)
+	{
+		// the area the frame covered has to be painted over, as well as the one it covers now
+		BoxFloat previous = frame.drawnRect();
+		frame.updateDrawnRect();
+		const BoxFloat& current = frame.drawnRect();
+		this->damage(previous);
+		this->damage(current);
+		++d_damagedFrames;
+
+		// the subtree of a frame that moved lies within the two areas damaged above, and its segments don't depend on where it is
+		if(frame.dirty() != DIRTY_ABSOLUTE)
+			frame.content().invalidate();
+	}
+
+	void MasterLayer::damage(const BoxFloat& rect)
+	{
+		if(rect.null() || rect.w() <= 0.f || rect.h() <= 0.f)
+			return;
+
+		if(d_damage.null())
+		{
+			d_damage = rect;
+			return;
+		}
+
+		float x0 = std::min(d_damage.x(), rect.x());
+		float y0 = std::min(d_damage.y(), rect.y());
+		float x1 = std::max(d_damage.x() + d_damage.w(), rect.x() + rect.w());
+		float y1 = std::max(d_damage.y() + d_damage.h(), rect.y() + rect.h());
+		d_damage.assign(x0, y0, x1 - x0, y1 - y0);
+	}
+
 	void MasterLayer::addLayer(Layer& layer)
 	{
 		layer.setIndex(d_layers.size());
@@ -128,7 +353,12 @@ namespace toy
 		this->collectLayers(d_layers, MASTER_LAYER);
 
 		for(Layer* layer : d_layers)
+		{
 			layer->setZ(layer->parentLayer() ? layer->parentLayer()->z() + layer->index() : layer->index());
+			// layers added since the last reorder follow the master layer
+			if(d_cacheLayers && !layer->cacheable())
+				layer->setCacheable(true);
+		}
 
 		auto goesBefore = [](Layer* a, Layer* b) { return a->z() < b->z(); };
 		std::sort(d_layers.begin(), d_layers.end(), goesBefore);
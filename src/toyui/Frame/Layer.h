@@ -7,6 +7,7 @@
 
 /* toy */
 #include <toyui/Frame/Stripe.h>
+#include <toyui/Frame/LayoutPool.h>
 
 namespace toy
 {
@@ -19,8 +20,9 @@ namespace toy
 		enum Redraw
 		{
 			NO_REDRAW = 0,
-			REDRAW = 1,
-			FORCE_REDRAW = 2
+			REPLAY = 1,
+			REDRAW = 2,
+			FORCE_REDRAW = 3
 		};
 
 		FrameType frameType() { return LAYER; }
@@ -32,14 +34,23 @@ namespace toy
 		void setIndex(size_t index) { d_index = index; }
 		void setZ(size_t z) { d_z = z; }
 
+		// a layer in which frames only moved replays its segments at their new place, without recording any
+		bool replay() { return d_redraw >= REPLAY; }
 		bool redraw() { return d_redraw >= REDRAW; }
 		bool forceRedraw() { return d_redraw >= FORCE_REDRAW; }
 
+		void setReplay() { if(d_redraw < REPLAY) d_redraw = REPLAY; }
 		void setRedraw() { if(d_redraw < REDRAW) d_redraw = REDRAW; }
 		void setForceRedraw() { d_redraw = FORCE_REDRAW; }
 
 		void endRedraw() { d_redraw = NO_REDRAW; }
 
+		// a cacheable layer is rendered to a texture once and composited from it until its content changes
+		bool cacheable() { return d_cacheable; }
+		void setCacheable(bool cacheable);
+
+		void markSublayers() { d_sublayersDirty = true; this->markDescendantDirty(DIRTY_MAPPING); }
+
 		void collectLayers(std::vector<Layer*>& layers, FrameType barrier = LAYER);
 
 		void remap();
@@ -50,35 +61,89 @@ namespace toy
 
 		Frame* pinpoint(float x, float y, const Filter& filter);
 
+		// the hit index is only kept up to date once it has been used
+		HitIndex& hitIndex();
+		void markHitRebuild();
+		void markHitMoved(Frame& frame);
+
+		static bool s_hitIndex;
+
 	protected:
 		Layer* d_parentLayer;
 		size_t d_index;
 		size_t d_z;
 
 		Redraw d_redraw;
+		bool d_cacheable;
 
 		std::vector<Layer*> d_sublayers;
+		bool d_sublayersDirty;
+
+		unique_ptr<HitIndex> d_hitIndex;
 	};
 
 	class TOY_UI_EXPORT MasterLayer : public Layer
 	{
 	public:
 		MasterLayer(Widget& widget);
+		~MasterLayer();
 
 		FrameType frameType() { return MASTER_LAYER; }
 
 		const std::vector<Layer*>& layers() { return d_layers; }
 		void markReorder() { d_reorder = true; }
 
+		size_t layoutVisits() { return d_layoutVisits; }
+
+		// with cached layers, every layer is rendered to a texture, the layers added afterwards included
+		bool cacheLayers() { return d_cacheLayers; }
+		void setCacheLayers(bool cached);
+
+		bool layoutStore() { return d_layoutStore != nullptr; }
+		void setLayoutStore(bool enabled);
+
+		// rows the layout store read from the frames and wrote back to them in the last relayout
+		size_t layoutLoaded();
+		size_t layoutStored();
+
+		size_t layoutThreads() { return d_layoutPool ? d_layoutPool->workers() : 0; }
+		void setLayoutThreads(size_t workers);
+
+		// with a budget in milliseconds, each relayout stops when it runs out and the pass resumes on the next one
+		float layoutBudget() { return d_layoutBudget; }
+		void setLayoutBudget(float milliseconds);
+		bool layoutPending();
+
 		void relayout();
 		void redraw();
+
+		// union of the areas that changed since the last render, empty when the previous image is still valid
+		const BoxFloat& damage() { return d_damage; }
+		bool damaged() { return !d_damage.null(); }
+		size_t damagedFrames() { return d_damagedFrames; }
+
+		void damage(const BoxFloat& rect);
+		void damageAll() { this->damage(BoxFloat(0.f, 0.f, d_size[DIM_X], d_size[DIM_Y])); }
+		void clearDamage() { d_damage.clear(); d_damagedFrames = 0; }
 		
 		void reorder();
 		void addLayer(Layer& layer);
 
 	protected:
+		void relayoutParallel();
+		void dispatchLayers(const std::vector<Frame*>& layers, void (Frame::*pass)());
+		void damageFrame(Frame& frame);
+
 		std::vector<Layer*> d_layers;
 		bool d_reorder;
+		bool d_cacheLayers;
+		size_t d_layoutVisits;
+		unique_ptr<LayoutStore> d_layoutStore;
+		unique_ptr<LayoutPool> d_layoutPool;
+		std::atomic<size_t> d_poolVisits;
+		float d_layoutBudget;
+		BoxFloat d_damage;
+		size_t d_damagedFrames;
 	};
 
 	class TOY_UI_EXPORT Layer3D : public MasterLayer
@@ -0,0 +1,102 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Frame/LayoutPool.h>
+
+namespace toy
+{
+	LayoutPool::LayoutPool(size_t workers)
+		: d_job(nullptr)
+		, d_count(0)
+		, d_next(0)
+		, d_finished(0)
+		, d_active(0)
+		, d_batch(0)
+		, d_quit(false)
+	{
+		for(size_t i = 0; i < workers; ++i)
+			d_threads.emplace_back([this] { this->work(); });
+	}
+
+	LayoutPool::~LayoutPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(d_mutex);
+			d_quit = true;
+		}
+
+		d_wake.notify_all();
+
+		for(std::thread& thread : d_threads)
+			thread.join();
+	}
+
+	void LayoutPool::dispatch(size_t count, const std::function<void(size_t)>& job)
+	{
+		if(count == 0)
+			return;
+
+		std::unique_lock<std::mutex> lock(d_mutex);
+
+		// a late worker might still be leaving the previous batch
+		d_done.wait(lock, [this] { return d_active == 0; });
+
+		d_job = &job;
+		d_count = count;
+		d_next = 0;
+		d_finished = 0;
+		++d_batch;
+
+		lock.unlock();
+		d_wake.notify_all();
+
+		this->runJobs();
+
+		lock.lock();
+		d_done.wait(lock, [this] { return d_finished == d_count && d_active == 0; });
+		d_job = nullptr;
+	}
+
+	void LayoutPool::work()
+	{
+		size_t batch = 0;
+
+		while(true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(d_mutex);
+				d_wake.wait(lock, [this, batch] { return d_quit || d_batch != batch; });
+				if(d_quit)
+					return;
+
+				batch = d_batch;
+				++d_active;
+			}
+
+			this->runJobs();
+
+			{
+				std::lock_guard<std::mutex> lock(d_mutex);
+				--d_active;
+			}
+
+			d_done.notify_all();
+		}
+	}
+
+	void LayoutPool::runJobs()
+	{
+		size_t index;
+		while((index = d_next++) < d_count)
+		{
+			(*d_job)(index);
+
+			std::lock_guard<std::mutex> lock(d_mutex);
+			++d_finished;
+		}
+
+		d_done.notify_all();
+	}
+}
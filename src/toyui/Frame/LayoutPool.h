@@ -0,0 +1,52 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_LAYOUTPOOL_H
+#define TOY_LAYOUTPOOL_H
+
+/* toy */
+#include <toyui/Forward.h>
+
+/* Standards */
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace toy
+{
+	/* Fixed set of worker threads running batches of independent jobs, the dispatching thread takes part in each batch */
+	class TOY_UI_EXPORT LayoutPool
+	{
+	public:
+		LayoutPool(size_t workers);
+		~LayoutPool();
+
+		size_t workers() { return d_threads.size(); }
+
+		void dispatch(size_t count, const std::function<void(size_t)>& job);
+
+	protected:
+		void work();
+		void runJobs();
+
+	protected:
+		std::vector<std::thread> d_threads;
+		std::mutex d_mutex;
+		std::condition_variable d_wake;
+		std::condition_variable d_done;
+
+		const std::function<void(size_t)>* d_job;
+		size_t d_count;
+		std::atomic<size_t> d_next;
+		size_t d_finished;
+		size_t d_active;
+		size_t d_batch;
+		bool d_quit;
+	};
+}
+
+#endif // TOY_LAYOUTPOOL_H
@@ -0,0 +1,840 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Frame/LayoutStore.h>
+
+#include <toyui/Frame/Stripe.h>
+#include <toyui/Render/DrawFrame.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace toy
+{
+	template <class T>
+	static void rearrange(std::vector<T>& values, size_t stride, const std::vector<int>& sources)
+	{
+		// row k takes the values of the previous row sources[k], new rows start out empty
+		std::vector<T> rows(sources.size() * stride);
+		for(size_t k = 0; k < sources.size(); ++k)
+			if(sources[k] >= 0)
+				std::copy_n(values.begin() + sources[k] * stride, stride, rows.begin() + k * stride);
+		values.swap(rows);
+	}
+
+	LayoutStore::LayoutStore()
+		: d_phase(IDLE)
+		, d_cursor(0)
+		, d_tierBegin(0)
+		, d_tierEnd(0)
+		, d_slices(0)
+		, d_visibleCount(0)
+		, d_loaded(0)
+		, d_stored(0)
+	{}
+
+	bool LayoutStore::relayout(Stripe& root, float budget)
+	{
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(budget));
+
+		d_loaded = 0;
+		d_stored = 0;
+
+		if(d_phase == IDLE)
+		{
+			if(root.subtreeDirty() < Frame::DIRTY_CONTENT)
+				return true;
+
+			if(d_frames.empty() || d_frames[0] != &root)
+			{
+				this->gather(root);
+				this->load();
+			}
+			else
+			{
+				this->update(false);
+			}
+
+			this->begin(root, budget > 0.f, false);
+		}
+		else if(d_frames[0] != &root)
+		{
+			// another tree : the pass starts over from scratch
+			this->gather(root);
+			this->load();
+			this->begin(root, true, false);
+		}
+		else if(root.subtreeDirty() >= Frame::DIRTY_CONTENT)
+		{
+			// frames changed since the last slice, the structure included : the pass starts over, still covering what was left to lay out
+			this->update(true);
+			this->begin(root, true, true);
+		}
+
+		++d_slices;
+
+		while(d_phase != IDLE)
+		{
+			size_t end = d_phase <= ACCUMULATE ? d_frames.size() : d_phase == STORE ? d_changes.size() : d_tierEnd;
+			while(d_cursor < end)
+			{
+				this->step(int(d_cursor++));
+				if(budget > 0.f && (d_cursor & 63) == 0 && Clock::now() >= deadline)
+					return false;
+			}
+
+			this->nextPhase();
+		}
+
+		return true;
+	}
+
+	void LayoutStore::begin(Stripe& root, bool visibleFirst, bool restart)
+	{
+		if(restart)
+		{
+			// the arrays already hold what the interrupted pass computed : its flags are kept so that the rows it changed,
+			// and the subtrees it had yet to go through, are still laid out and written back
+			d_changes.erase(std::remove_if(d_changes.begin(), d_changes.end(), [this](int i) { return !d_changed[i]; }), d_changes.end());
+		}
+		else
+		{
+			std::fill(d_resized.begin(), d_resized.end(), false);
+			std::fill(d_sizeChanged.begin(), d_sizeChanged.end(), false);
+			std::fill(d_spanChanged.begin(), d_spanChanged.end(), false);
+			std::fill(d_positioned.begin(), d_positioned.end(), false);
+			std::fill(d_positionChanged.begin(), d_positionChanged.end(), false);
+			std::fill(d_changed.begin(), d_changed.end(), false);
+			d_changes.clear();
+		}
+
+		d_resized[0] = d_resized[0] || d_subtreeDirty[0] >= Frame::DIRTY_CONTENT;
+		d_positioned[0] = d_positioned[0] || d_subtreeDirty[0] >= Frame::DIRTY_CONTENT || (!d_widget[0] && d_dirty[0] >= Frame::DIRTY_ABSOLUTE);
+
+		if(visibleFirst)
+		{
+			this->prioritize(root);
+		}
+		else
+		{
+			d_order.clear();
+			d_visibleCount = d_frames.size();
+		}
+
+		d_phase = MEASURE;
+		d_cursor = 0;
+		d_tierBegin = 0;
+		d_tierEnd = d_visibleCount;
+		d_slices = 0;
+	}
+
+	void LayoutStore::prioritize(Stripe& root)
+	{
+		int count = int(d_frames.size());
+
+		d_absolute.resize(count * 2);
+		d_scale.resize(count);
+		d_visible.resize(count);
+		d_order.clear();
+
+		// the visible region is found from the previous geometry, a frame only counts as visible if its parent does
+		for(int i = 0; i < count; ++i)
+		{
+			int parent = d_parent[i];
+			if(parent < 0)
+			{
+				d_absolute[i * 2 + DIM_X] = 0.f;
+				d_absolute[i * 2 + DIM_Y] = 0.f;
+				d_scale[i] = 1.f;
+				d_visible[i] = true;
+				d_order.push_back(i);
+				continue;
+			}
+
+			float scale = d_scale[parent];
+			bool inside = d_visible[parent] && !d_hidden[i];
+			for(int dim = 0; dim < 2; ++dim)
+			{
+				float position = d_absolute[parent * 2 + dim] + (d_widget[i] ? d_position[i * 2 + dim] * scale : 0.f);
+				float extent = d_size[i * 2 + dim] * scale;
+				d_absolute[i * 2 + dim] = position;
+				inside &= !d_widget[i] || (position < root.dsize(Dimension(dim)) && position + extent > 0.f);
+			}
+
+			d_scale[i] = d_widget[i] ? scale * d_zoom[i] : scale;
+			d_visible[i] = inside;
+			if(inside)
+				d_order.push_back(i);
+		}
+
+		d_visibleCount = d_order.size();
+
+		for(int i = 0; i < count; ++i)
+			if(!d_visible[i])
+				d_order.push_back(i);
+	}
+
+	void LayoutStore::step(int i)
+	{
+		switch(d_phase)
+		{
+		case MEASURE: this->measure(i); break;
+		case ACCUMULATE: this->accumulate(d_postorder[i]); break;
+		case RESIZE: this->resize(d_order.empty() ? i : d_order[i]); break;
+		case POSITION: this->position(d_order.empty() ? i : d_order[i]); break;
+		case STORE: this->store(d_changes[i]); break;
+		case IDLE: break;
+		}
+	}
+
+	void LayoutStore::nextPhase()
+	{
+		if(d_phase == STORE && d_tierEnd < d_frames.size())
+		{
+			// the visible frames are written back, now the others
+			d_tierBegin = d_tierEnd;
+			d_tierEnd = d_frames.size();
+			d_phase = RESIZE;
+		}
+		else
+		{
+			d_phase = d_phase == STORE ? IDLE : Phase(d_phase + 1);
+		}
+
+		if(d_phase == IDLE)
+		{
+			d_changes.clear();
+			this->indexStripes();
+		}
+
+		d_cursor = d_phase <= ACCUMULATE || d_phase == STORE ? 0 : d_tierBegin;
+	}
+
+	void LayoutStore::gather(Stripe& root)
+	{
+		d_frames.clear();
+		d_parent.clear();
+		d_subtreeEnd.clear();
+		d_childBegin.clear();
+		d_childCount.clear();
+		d_sequenceSize.clear();
+		d_children.clear();
+		d_postorder.clear();
+
+		this->gather(root, -1);
+
+		size_t count = d_frames.size();
+
+		d_before.resize(count);
+		d_hidden.resize(count);
+		d_stripe.resize(count);
+		d_widget.resize(count);
+		d_flow.resize(count);
+		d_posflow.resize(count);
+		d_sizeflow.resize(count);
+		d_length.resize(count);
+		d_dirty.resize(count);
+		d_subtreeDirty.resize(count);
+		d_autoLayout.resize(count * 2);
+		d_sizing.resize(count * 2);
+		d_align.resize(count * 2);
+		d_padding.resize(count * 4);
+		d_margin.resize(count * 2);
+		d_spacing.resize(count);
+		d_fixed.resize(count * 2);
+		d_zoom.resize(count);
+
+		d_content.resize(count * 2);
+		d_spaceContent.resize(count * 2);
+		d_contentExpand.resize(count);
+		d_span.resize(count * 2);
+		d_size.resize(count * 2);
+		d_position.resize(count * 2);
+		d_offset.resize(count * 2);
+
+		d_measured.resize(count);
+		d_resized.resize(count);
+		d_positioned.resize(count);
+		d_sizeChanged.resize(count);
+		d_positionChanged.resize(count);
+		d_spanChanged.resize(count);
+		d_changed.resize(count);
+	}
+
+	int LayoutStore::addRow(Frame& frame, int parent)
+	{
+		int id = int(d_frames.size());
+		d_frames.push_back(&frame);
+		d_parent.push_back(parent);
+		d_subtreeEnd.push_back(0);
+		d_childBegin.push_back(int(d_children.size()));
+		d_childCount.push_back(0);
+		d_sequenceSize.push_back(0);
+		return id;
+	}
+
+	int LayoutStore::gather(Frame& frame, int parent)
+	{
+		int id = this->addRow(frame, parent);
+
+		if(frame.frameType() >= STRIPE)
+		{
+			Stripe& stripe = frame.as<Stripe>();
+			int begin = int(d_children.size());
+			int count = int(stripe.contents().size());
+
+			d_childCount[id] = count;
+			d_sequenceSize[id] = int(stripe.sequence().size());
+			d_children.resize(begin + count);
+
+			for(int k = 0; k < count; ++k)
+			{
+				int child = this->gather(*stripe.contents()[k], id);
+				d_children[begin + k] = child;
+			}
+		}
+
+		d_subtreeEnd[id] = int(d_frames.size());
+		d_postorder.push_back(id);
+		return id;
+	}
+
+	void LayoutStore::regather()
+	{
+		// only the contents of stripes whose structure changed are read again : the rows of clean subtrees are copied as they are,
+		// and the rows of frames still in place keep their values under their new id
+		Topology previous;
+		previous.frames.swap(d_frames);
+		previous.parent.swap(d_parent);
+		previous.subtreeEnd.swap(d_subtreeEnd);
+		previous.childBegin.swap(d_childBegin);
+		previous.childCount.swap(d_childCount);
+		previous.sequenceSize.swap(d_sequenceSize);
+		previous.children.swap(d_children);
+
+		std::vector<int> sources;
+		std::vector<int> relinked;
+		this->regather(*previous.frames[0], -1, 0, previous, sources, relinked);
+		this->indexPostorder();
+
+		rearrange(d_before, 1, sources);
+		rearrange(d_hidden, 1, sources);
+		rearrange(d_stripe, 1, sources);
+		rearrange(d_widget, 1, sources);
+		rearrange(d_flow, 1, sources);
+		rearrange(d_posflow, 1, sources);
+		rearrange(d_sizeflow, 1, sources);
+		rearrange(d_length, 1, sources);
+		rearrange(d_dirty, 1, sources);
+		rearrange(d_subtreeDirty, 1, sources);
+		rearrange(d_autoLayout, 2, sources);
+		rearrange(d_sizing, 2, sources);
+		rearrange(d_align, 2, sources);
+		rearrange(d_padding, 4, sources);
+		rearrange(d_margin, 2, sources);
+		rearrange(d_spacing, 1, sources);
+		rearrange(d_fixed, 2, sources);
+		rearrange(d_zoom, 1, sources);
+
+		rearrange(d_content, 2, sources);
+		rearrange(d_spaceContent, 2, sources);
+		rearrange(d_contentExpand, 1, sources);
+		rearrange(d_span, 2, sources);
+		rearrange(d_size, 2, sources);
+		rearrange(d_position, 2, sources);
+		rearrange(d_offset, 2, sources);
+
+		rearrange(d_measured, 1, sources);
+		rearrange(d_resized, 1, sources);
+		rearrange(d_positioned, 1, sources);
+		rearrange(d_sizeChanged, 1, sources);
+		rearrange(d_positionChanged, 1, sources);
+		rearrange(d_spanChanged, 1, sources);
+		rearrange(d_changed, 1, sources);
+
+		std::vector<int> moved(previous.frames.size(), -1);
+		for(size_t k = 0; k < sources.size(); ++k)
+			if(sources[k] >= 0)
+				moved[sources[k]] = int(k);
+
+		for(int i = 0, count = int(d_frames.size()); i < count; ++i)
+		{
+			if(sources[i] >= 0)
+			{
+				d_before[i] = d_before[i] >= 0 ? moved[d_before[i]] : -1;
+				continue;
+			}
+
+			// frames new to the tree, or to their parent, are read and laid out in full
+			this->loadRow(i, false);
+			d_dirty[i] = d_frames[i]->dirty();
+			d_subtreeDirty[i] = std::max(uint8_t(d_frames[i]->subtreeDirty()), uint8_t(Frame::DIRTY_CONTENT));
+			relinked.push_back(i);
+			++d_loaded;
+		}
+
+		for(int parent : relinked)
+			this->linkSiblings(parent);
+
+		// rows removed don't need to be written back anymore, the others are written back under their new id
+		for(int& i : d_changes)
+			i = moved[i];
+		d_changes.erase(std::remove(d_changes.begin(), d_changes.end(), -1), d_changes.end());
+	}
+
+	int LayoutStore::regather(Frame& frame, int parent, int row, const Topology& previous, std::vector<int>& sources, std::vector<int>& relinked)
+	{
+		if(row < 0)
+		{
+			int id = this->gather(frame, parent);
+			sources.resize(d_frames.size(), -1);
+			return id;
+		}
+
+		if(frame.subtreeDirty() < Frame::DIRTY_STRUCTURE)
+			return this->copyRows(row, parent, previous, sources);
+
+		int id = this->addRow(frame, parent);
+		sources.push_back(row);
+		relinked.push_back(id);
+
+		if(frame.frameType() >= STRIPE)
+		{
+			Stripe& stripe = frame.as<Stripe>();
+			int begin = int(d_children.size());
+			int count = int(stripe.contents().size());
+
+			d_childCount[id] = count;
+			d_sequenceSize[id] = int(stripe.sequence().size());
+			d_children.resize(begin + count);
+
+			// frames that stay in the stripe are found among its previous children
+			std::unordered_map<Frame*, int> rows;
+			for(int k = previous.childBegin[row], end = k + previous.childCount[row]; k < end; ++k)
+				rows[previous.frames[previous.children[k]]] = previous.children[k];
+
+			for(int k = 0; k < count; ++k)
+			{
+				Frame& child = *stripe.contents()[k];
+				auto it = rows.find(&child);
+				int index = this->regather(child, id, it != rows.end() ? it->second : -1, previous, sources, relinked);
+				d_children[begin + k] = index;
+			}
+		}
+
+		d_subtreeEnd[id] = int(d_frames.size());
+		return id;
+	}
+
+	int LayoutStore::copyRows(int row, int parent, const Topology& previous, std::vector<int>& sources)
+	{
+		// a subtree keeps its layout in pre-order, only its ids move
+		int first = int(d_frames.size());
+		int offset = first - row;
+		for(int r = row, end = previous.subtreeEnd[row]; r < end; ++r)
+		{
+			d_frames.push_back(previous.frames[r]);
+			d_parent.push_back(r == row ? parent : previous.parent[r] + offset);
+			d_subtreeEnd.push_back(previous.subtreeEnd[r] + offset);
+			d_childBegin.push_back(int(d_children.size()));
+			d_childCount.push_back(previous.childCount[r]);
+			d_sequenceSize.push_back(previous.sequenceSize[r]);
+			for(int k = previous.childBegin[r], last = k + previous.childCount[r]; k < last; ++k)
+				d_children.push_back(previous.children[k] + offset);
+			sources.push_back(r);
+		}
+		return first;
+	}
+
+	void LayoutStore::indexPostorder()
+	{
+		// a frame comes after its subtree, which ends where the subtree of its last child ends
+		d_postorder.clear();
+		std::vector<int> open;
+		for(int i = 0, count = int(d_frames.size()); i < count; ++i)
+		{
+			while(!open.empty() && d_subtreeEnd[open.back()] <= i)
+			{
+				d_postorder.push_back(open.back());
+				open.pop_back();
+			}
+			open.push_back(i);
+		}
+
+		while(!open.empty())
+		{
+			d_postorder.push_back(open.back());
+			open.pop_back();
+		}
+	}
+
+	void LayoutStore::load()
+	{
+		int count = int(d_frames.size());
+
+		for(int i = 0; i < count; ++i)
+		{
+			this->loadRow(i, false);
+			d_dirty[i] = d_frames[i]->dirty();
+			d_subtreeDirty[i] = d_frames[i]->subtreeDirty();
+		}
+
+		for(int i = 0; i < count; ++i)
+			this->linkSiblings(i);
+
+		d_loaded += count;
+	}
+
+	void LayoutStore::update(bool merge)
+	{
+		// only frames marked dirty since the last pass are read again, subtrees without any are skipped over
+		// a pass starting over keeps the dirty state it was loaded with
+		if(!merge)
+		{
+			std::fill(d_dirty.begin(), d_dirty.end(), uint8_t(Frame::CLEAN));
+			std::fill(d_subtreeDirty.begin(), d_subtreeDirty.end(), uint8_t(Frame::CLEAN));
+		}
+
+		// stripes mark themselves when their contents change
+		if(d_frames[0]->subtreeDirty() >= Frame::DIRTY_STRUCTURE)
+			this->regather();
+
+		int count = int(d_frames.size());
+		int i = 0;
+		while(i < count)
+		{
+			Frame& frame = *d_frames[i];
+			if(frame.subtreeDirty() == Frame::CLEAN)
+			{
+				i = d_subtreeEnd[i];
+				continue;
+			}
+
+			if(frame.dirty() > Frame::CLEAN)
+			{
+				bool hidden = d_hidden[i] != 0;
+				this->loadRow(i, merge && d_changed[i]);
+				if(d_parent[i] >= 0 && hidden != (d_hidden[i] != 0))
+					this->linkSiblings(d_parent[i]);
+
+				// a hidden subtree isn't laid out, what changed in it meanwhile is laid out when it shows again
+				if(hidden && !d_hidden[i])
+					for(int k = i; k < d_subtreeEnd[i]; ++k)
+						d_subtreeDirty[k] = std::max(d_subtreeDirty[k], uint8_t(Frame::DIRTY_CONTENT));
+				++d_loaded;
+			}
+
+			d_dirty[i] = std::max(d_dirty[i], uint8_t(frame.dirty()));
+			d_subtreeDirty[i] = std::max(d_subtreeDirty[i], uint8_t(frame.subtreeDirty()));
+			++i;
+		}
+	}
+
+	void LayoutStore::loadRow(int i, bool pending)
+	{
+		Frame& frame = *d_frames[i];
+		LayoutStyle& layout = frame.style().layout();
+
+		d_hidden[i] = frame.hidden();
+		d_stripe[i] = frame.frameType() >= STRIPE;
+		d_widget[i] = frame.widget() != nullptr;
+		d_flow[i] = frame.flow();
+		d_posflow[i] = frame.posflow();
+		d_sizeflow[i] = frame.sizeflow();
+		d_length[i] = frame.length();
+		d_spacing[i] = layout.spacing()[frame.length()];
+		d_contentExpand[i] = frame.contentExpand();
+		d_zoom[i] = frame.scale();
+
+		const BoxFloat& padding = layout.padding();
+		for(int p = 0; p < 4; ++p)
+			d_padding[i * 4 + p] = padding[p];
+
+		for(int dim = 0; dim < 2; ++dim)
+		{
+			Dimension d = Dimension(dim);
+			d_autoLayout[i * 2 + dim] = layout.layout()[d];
+			d_sizing[i * 2 + dim] = frame.dsizing(d);
+			d_align[i * 2 + dim] = frame.dalign(d);
+			d_margin[i * 2 + dim] = frame.dmargin(d);
+			d_fixed[i * 2 + dim] = layout.size()[d];
+			d_content[i * 2 + dim] = frame.dcontent(d);
+			d_spaceContent[i * 2 + dim] = frame.dspaceContent(d);
+		}
+
+		// what an interrupted pass computed and didn't write back yet is newer than the frame geometry
+		for(int dim = 0; dim < 2; ++dim)
+		{
+			Dimension d = Dimension(dim);
+			if(!pending || !d_spanChanged[i])
+				d_span[i * 2 + dim] = frame.dspan(d);
+			if(!pending || !d_sizeChanged[i])
+				d_size[i * 2 + dim] = frame.dsize(d);
+			if(!pending || !d_positionChanged[i])
+				d_position[i * 2 + dim] = frame.dposition(d);
+		}
+	}
+
+	void LayoutStore::linkSiblings(int parent)
+	{
+		// the frame before another is the closest visible frame preceding it in its parent
+		int before = -1;
+		for(int k = d_childBegin[parent], end = k + d_childCount[parent]; k < end; ++k)
+		{
+			int child = d_children[k];
+			d_before[child] = before;
+			if(!d_hidden[child])
+				before = child;
+		}
+	}
+
+	void LayoutStore::measure(int i)
+	{
+		d_measured[i] = d_subtreeDirty[i] >= Frame::DIRTY_CONTENT;
+		if(!d_measured[i])
+			return;
+
+		this->changed(i);
+
+		if(d_stripe[i])
+		{
+			d_content[i * 2 + DIM_X] = 0.f;
+			d_content[i * 2 + DIM_Y] = 0.f;
+			d_spaceContent[i * 2 + DIM_X] = 0.f;
+			d_spaceContent[i * 2 + DIM_Y] = 0.f;
+			d_contentExpand[i] = false;
+		}
+
+		if(!d_stripe[i] || d_sequenceSize[i] < 1)
+		{
+			d_content[i * 2 + DIM_X] = d_frames[i]->content().extentSize(DIM_X);
+			d_content[i * 2 + DIM_Y] = d_frames[i]->content().extentSize(DIM_Y);
+		}
+	}
+
+	void LayoutStore::accumulate(int i)
+	{
+		// frames accumulate in post-order : each frame is complete before it is accumulated, and siblings accumulate in order
+		int parent = d_parent[i];
+		if(parent < 0 || !d_measured[parent])
+			return;
+
+		++Stripe::layoutVisits();
+
+		if(d_hidden[i] || !d_sizeflow[i])
+			return;
+
+		int length = d_length[parent];
+		float spacing = d_before[i] >= 0 ? d_spacing[parent] : 0.f;
+
+		for(int dim : { length, 1 - length })
+		{
+			Sizing sizing = d_sizing[i * 2 + dim];
+			if(sizing > WRAP)
+				continue;
+
+			float measure = this->measure(i, dim);
+			bool sequence = dim == length && d_flow[i];
+
+			float& content = d_content[parent * 2 + dim];
+			content = sequence ? content + measure + spacing : std::max(content, measure);
+
+			if(sizing > SHRINK || !d_flow[i])
+				continue;
+
+			float& spaceContent = d_spaceContent[parent * 2 + dim];
+			spaceContent = sequence ? spaceContent + measure + spacing : std::max(spaceContent, measure);
+		}
+
+		if(d_sizing[i * 2 + length] > WRAP)
+			d_contentExpand[parent] = true;
+	}
+
+	void LayoutStore::resize(int parent)
+	{
+		if(!d_resized[parent])
+			return;
+
+		size_t& visits = Stripe::layoutVisits();
+
+		int length = d_length[parent];
+		int begin = d_childBegin[parent];
+		int sequence = begin + d_sequenceSize[parent];
+		int end = begin + d_childCount[parent];
+
+		float span = 0.f;
+		for(int k = begin; k < sequence; ++k)
+			if(d_sizing[d_children[k] * 2 + length] >= WRAP && !d_hidden[d_children[k]])
+				span += d_span[d_children[k] * 2 + length];
+
+		for(int k = begin; k < sequence; ++k)
+			if(d_sizing[d_children[k] * 2 + length] >= WRAP && !d_hidden[d_children[k]])
+			{
+				d_span[d_children[k] * 2 + length] /= span;
+				d_spanChanged[d_children[k]] = true;
+				this->changed(d_children[k]);
+			}
+
+		for(int k = begin; k < end; ++k)
+		{
+			int i = d_children[k];
+
+			++visits;
+
+			if(d_hidden[i])
+				continue;
+
+			for(int dim : { length, 1 - length })
+			{
+				if(d_autoLayout[parent * 2 + dim] < AUTO_SIZE)
+					continue;
+
+				float space = this->space(parent, dim);
+				if(dim == length)
+					space = (space - d_spaceContent[parent * 2 + dim]) * d_span[i * 2 + length];
+
+				float content = d_content[i * 2 + dim] + d_padding[i * 4 + dim] + d_padding[i * 4 + dim + 2];
+				float expand = std::max(0.f, space - content);
+
+				float size = d_size[i * 2 + dim];
+				Sizing sizing = d_sizing[i * 2 + dim];
+				if(sizing == SHRINK)
+					size = content;
+				else if(sizing == WRAP)
+					size = content + expand;
+				else if(sizing == EXPAND)
+					size = space;
+
+				if(size != d_size[i * 2 + dim])
+				{
+					d_size[i * 2 + dim] = size;
+					d_sizeChanged[i] = true;
+					this->changed(i);
+				}
+			}
+
+			d_resized[i] = d_subtreeDirty[i] >= Frame::DIRTY_CONTENT || d_sizeChanged[i];
+		}
+	}
+
+	void LayoutStore::position(int parent)
+	{
+		// frames without a widget offset their contents by their own position
+		int above = d_parent[parent];
+		for(int dim = 0; dim < 2; ++dim)
+			d_offset[parent * 2 + dim] = above >= 0 && !d_widget[parent] ? d_position[parent * 2 + dim] + d_offset[above * 2 + dim] : 0.f;
+
+		if(!d_positioned[parent])
+			return;
+
+		size_t& visits = Stripe::layoutVisits();
+
+		int length = d_length[parent];
+
+		for(int k = d_childBegin[parent], end = k + d_childCount[parent]; k < end; ++k)
+		{
+			int i = d_children[k];
+
+			++visits;
+
+			if(d_hidden[i])
+				continue;
+
+			if(d_posflow[i])
+				for(int dim : { length, 1 - length })
+				{
+					if(d_autoLayout[parent * 2 + dim] < AUTO_LAYOUT)
+						continue;
+
+					float offset = d_widget[i] ? d_offset[parent * 2 + dim] : 0.f;
+					float space = this->space(parent, dim);
+
+					float position;
+					if(dim == length && d_flow[i])
+						position = this->positionSequence(parent, i, offset, d_contentExpand[parent] ? 0.f : space - d_content[parent * 2 + length]);
+					else
+						position = this->positionFree(parent, i, dim, offset, space);
+
+					if(position != d_position[i * 2 + dim])
+					{
+						d_position[i * 2 + dim] = position;
+						d_positionChanged[i] = true;
+						this->changed(i);
+					}
+				}
+
+			bool moved = !d_widget[i] && (d_dirty[i] >= Frame::DIRTY_ABSOLUTE || d_positionChanged[i]);
+			d_positioned[i] = d_subtreeDirty[i] >= Frame::DIRTY_CONTENT || d_sizeChanged[i] || moved;
+		}
+	}
+
+	float LayoutStore::positionSequence(int parent, int i, float offset, float space)
+	{
+		int length = d_length[parent];
+		int before = d_before[i];
+
+		float align = space * AlignSpace[d_align[i * 2 + DIM_X]];
+		if(before >= 0)
+			return d_position[before * 2 + length] + this->extent(before, length) + d_spacing[parent] - space * AlignSpace[d_align[before * 2 + DIM_X]] + align;
+		else
+			return offset + d_padding[parent * 4 + length] + d_margin[i * 2 + length] + align;
+	}
+
+	float LayoutStore::positionFree(int parent, int i, int dim, float offset, float space)
+	{
+		Align align = d_align[i * 2 + (dim == d_length[parent] ? DIM_X : DIM_Y)];
+		float alignOffset = space * AlignSpace[align] - this->extent(i, dim) * AlignExtent[align];
+		return offset + (d_flow[i] ? d_padding[parent * 4 + dim] + d_margin[i * 2 + dim] : 0.f) + alignOffset;
+	}
+
+	void LayoutStore::store(int i)
+	{
+		// the visible frames are written back first, the others once the rest of the tree is laid out
+		if(!d_changed[i] || (d_tierEnd < d_frames.size() && !d_visible[i]))
+			return;
+
+		d_changed[i] = false;
+		++d_stored;
+
+		Frame& frame = *d_frames[i];
+
+		if(d_measured[i])
+		{
+			frame.setContentSize(DimFloat(d_content[i * 2 + DIM_X], d_content[i * 2 + DIM_Y]));
+			if(d_stripe[i])
+				frame.setSpaceContent(DimFloat(d_spaceContent[i * 2 + DIM_X], d_spaceContent[i * 2 + DIM_Y]), d_contentExpand[i] != 0);
+		}
+
+		if(d_spanChanged[i])
+		{
+			frame.setSpanDimDirect(DIM_X, d_span[i * 2 + DIM_X]);
+			frame.setSpanDimDirect(DIM_Y, d_span[i * 2 + DIM_Y]);
+		}
+
+		if(d_sizeChanged[i])
+		{
+			frame.setSizeDim(DIM_X, d_size[i * 2 + DIM_X]);
+			frame.setSizeDim(DIM_Y, d_size[i * 2 + DIM_Y]);
+		}
+
+		if(i > 0 && d_resized[i])
+			frame.content().updateContentSize();
+
+		if(d_positionChanged[i])
+			frame.setPosition(d_position[i * 2 + DIM_X], d_position[i * 2 + DIM_Y]);
+
+		// the offsets of the parent don't hold until the pass completes and indexes it again
+		if(i > 0 && (d_sizeChanged[i] || d_positionChanged[i]))
+			d_frames[d_parent[i]]->as<Stripe>().resetIndex();
+	}
+
+	void LayoutStore::indexStripes()
+	{
+		for(int i = 0, count = int(d_frames.size()); i < count; ++i)
+			if(d_stripe[i] && (d_measured[i] || d_positioned[i]))
+				d_frames[i]->as<Stripe>().indexContents();
+	}
+}
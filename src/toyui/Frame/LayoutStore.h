@@ -0,0 +1,173 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_LAYOUTSTORE_H
+#define TOY_LAYOUTSTORE_H
+
+/* toy */
+#include <toyui/Forward.h>
+#include <toyui/Frame/Frame.h>
+
+/* Standards */
+#include <vector>
+#include <chrono>
+
+namespace toy
+{
+	/* Flattened copy of a frame tree : box geometry and resolved layout parameters live in contiguous arrays indexed by frame id,
+	   frame ids are assigned in pre-order and children are stored as ranges of ids, so that each layout pass is a linear sweep.
+	   Per dimension values are interleaved : value for frame i in dimension dim is at [i * 2 + dim].
+	   The arrays are authoritative between passes : a pass only reads again the rows of frames marked dirty since the last one,
+	   and only writes back the rows it changed. A change of structure only reads again the contents of the stripes it touched,
+	   the other rows are moved to their new id along with their values.
+	   A relayout given a time budget stops when it runs out and resumes on the next call : frames in the visible region are resized,
+	   positioned and written back first, the others keep their previous geometry until the pass completes.
+	   The stripes a pass laid out index their shown contents and offsets again once it completes. */
+	class TOY_UI_EXPORT LayoutStore
+	{
+	public:
+		LayoutStore();
+
+		enum Phase
+		{
+			IDLE,
+			MEASURE,
+			ACCUMULATE,
+			RESIZE,
+			POSITION,
+			STORE
+		};
+
+		size_t size() { return d_frames.size(); }
+		bool pending() { return d_phase != IDLE; }
+		size_t slices() { return d_slices; }
+
+		// rows read from the frames and written back to them by the last relayout
+		size_t loaded() { return d_loaded; }
+		size_t stored() { return d_stored; }
+
+		// returns true once the pass is complete, a budget of zero lays out the whole tree at once
+		bool relayout(Stripe& root, float budget = 0.f);
+
+	protected:
+		void begin(Stripe& root, bool visibleFirst, bool restart);
+
+		// topology of the previous gather, while the rows are patched to match the frames
+		struct Topology
+		{
+			std::vector<Frame*> frames;
+			std::vector<int> parent;
+			std::vector<int> subtreeEnd;
+			std::vector<int> childBegin;
+			std::vector<int> childCount;
+			std::vector<int> sequenceSize;
+			std::vector<int> children;
+		};
+
+		void gather(Stripe& root);
+		int gather(Frame& frame, int parent);
+		int addRow(Frame& frame, int parent);
+
+		void regather();
+		int regather(Frame& frame, int parent, int row, const Topology& previous, std::vector<int>& sources, std::vector<int>& relinked);
+		int copyRows(int row, int parent, const Topology& previous, std::vector<int>& sources);
+		void indexPostorder();
+
+		void load();
+		void update(bool merge);
+		void loadRow(int i, bool pending);
+		void linkSiblings(int parent);
+		void prioritize(Stripe& root);
+
+		void step(int i);
+		void nextPhase();
+
+		void measure(int i);
+		void accumulate(int i);
+		void resize(int parent);
+		void position(int parent);
+		void store(int i);
+		void indexStripes();
+
+		inline void changed(int i) { if(!d_changed[i]) { d_changed[i] = true; d_changes.push_back(i); } }
+
+		inline float space(int i, int dim) { return d_size[i * 2 + dim] - d_padding[i * 4 + dim] - d_padding[i * 4 + dim + 2]; }
+		inline float extent(int i, int dim) { return d_size[i * 2 + dim] + d_margin[i * 2 + dim] * 2.f; }
+		inline float bounds(int i, int dim) { return d_content[i * 2 + dim] + d_padding[i * 4 + dim] + d_padding[i * 4 + dim + 2] + d_margin[i * 2 + dim] * 2.f; }
+		inline float measure(int i, int dim) { return std::max(bounds(i, dim), d_fixed[i * 2 + dim]); }
+
+		float positionSequence(int parent, int i, float offset, float space);
+		float positionFree(int parent, int i, int dim, float offset, float space);
+
+	protected:
+		// pass progress : phases over the resize, position and store order run once for the visible frames, then for the others
+		Phase d_phase;
+		size_t d_cursor;
+		size_t d_tierBegin;
+		size_t d_tierEnd;
+		size_t d_slices;
+		std::vector<int> d_order;
+		size_t d_visibleCount;
+		size_t d_loaded;
+		size_t d_stored;
+
+		// topology
+		std::vector<Frame*> d_frames;
+		std::vector<int> d_parent;
+		std::vector<int> d_subtreeEnd;
+		std::vector<int> d_childBegin;
+		std::vector<int> d_childCount;
+		std::vector<int> d_sequenceSize;
+		std::vector<int> d_children;
+		std::vector<int> d_postorder;
+
+		// resolved layout parameters
+		std::vector<int> d_before;
+		std::vector<uint8_t> d_hidden;
+		std::vector<uint8_t> d_stripe;
+		std::vector<uint8_t> d_widget;
+		std::vector<uint8_t> d_flow;
+		std::vector<uint8_t> d_posflow;
+		std::vector<uint8_t> d_sizeflow;
+		std::vector<uint8_t> d_length;
+		std::vector<uint8_t> d_dirty;
+		std::vector<uint8_t> d_subtreeDirty;
+		std::vector<uint8_t> d_autoLayout;
+		std::vector<Sizing> d_sizing;
+		std::vector<Align> d_align;
+		std::vector<float> d_padding;
+		std::vector<float> d_margin;
+		std::vector<float> d_spacing;
+		std::vector<float> d_fixed;
+		std::vector<float> d_zoom;
+
+		// box geometry
+		std::vector<float> d_content;
+		std::vector<float> d_spaceContent;
+		std::vector<uint8_t> d_contentExpand;
+		std::vector<float> d_span;
+		std::vector<float> d_size;
+		std::vector<float> d_position;
+		std::vector<float> d_offset;
+
+		// pass state
+		std::vector<uint8_t> d_measured;
+		std::vector<uint8_t> d_resized;
+		std::vector<uint8_t> d_positioned;
+		std::vector<uint8_t> d_sizeChanged;
+		std::vector<uint8_t> d_positionChanged;
+		std::vector<uint8_t> d_spanChanged;
+
+		// rows to write back, in the order they changed
+		std::vector<uint8_t> d_changed;
+		std::vector<int> d_changes;
+
+		// previous geometry in root coordinates, to find the visible region
+		std::vector<float> d_absolute;
+		std::vector<float> d_scale;
+		std::vector<uint8_t> d_visible;
+	};
+}
+
+#endif // TOY_LAYOUTSTORE_H
@@ -10,46 +10,135 @@
 #include <toyui/Widget/Widget.h>
 #include <toyui/Widget/Sheet.h>
 
+#include <toyui/Frame/Layer.h>
+#include <toyui/Frame/HitIndex.h>
+
 #include <algorithm>
 
 namespace toy
 {
+	bool Stripe::s_layoutKernels = true;
+
+	static thread_local size_t t_layoutVisits = 0;
+	static thread_local Layer* t_deferLayer = nullptr;
+	static thread_local FrameVector* t_deferred = nullptr;
+
+	size_t& Stripe::layoutVisits()
+	{
+		return t_layoutVisits;
+	}
+
+	void Stripe::deferSublayers(Layer* layer, FrameVector* deferred)
+	{
+		t_deferLayer = layer;
+		t_deferred = deferred;
+	}
+
+	bool Stripe::deferred(Frame& frame)
+	{
+		// sublayers of the deferring layer are laid out separately once their parent pass is done
+		return t_deferLayer && frame.frameType() == LAYER && frame.as<Layer>().parentLayer() == t_deferLayer;
+	}
+
 	Stripe::Stripe(Widget& widget)
 		: Frame(widget)
 		, d_contents()
 		, d_sequence(d_contents)
+		, d_shownIndexed(false)
+		, d_offsetsIndexed(false)
 	{}
 
 	Stripe::Stripe(Style& style, Stripe& parent)
 		: Frame(style, parent)
 		, d_contents()
 		, d_sequence(d_contents)
+		, d_shownIndexed(false)
+		, d_offsetsIndexed(false)
 	{}
 
 	void Stripe::map(Frame& frame)
 	{
-		frame.bind(*this);
+		// frames kept bound through a batched change are only inserted back
+		if(frame.parent() != this)
+			frame.bind(*this);
 		this->insert(frame, frame.widget()->index());
 	}
 
 	void Stripe::unmap(Frame& frame)
 	{
 		frame.unbind();
-		this->remove(frame);
+
+		// after a batched change the contents are empty until the next remap
+		size_t index = frame.dindex(d_length);
+		if(index < d_contents.size() && d_contents[index] == &frame)
+			this->remove(frame);
 	}
 
 	void Stripe::remap()
 	{
-		if(d_dirty < DIRTY_MAPPING)
+		if(this->subtreeDirty() < DIRTY_MAPPING && d_remaps.empty())
 			return;
 
-		this->unmap();
+		bool descendants = d_descendantDirty >= DIRTY_MAPPING;
 
-		for(Widget* widget : d_widget->as<Wedge>().contents())
+		if(d_dirty >= DIRTY_MAPPING)
 		{
-			this->map(widget->frame());
-			widget->frame().remap();
+			d_remaps.clear();
+			this->unmap();
+
+			for(Widget* widget : d_widget->as<Wedge>().contents())
+				this->map(widget->frame());
+
+			descendants = true;
 		}
+		else if(!d_remaps.empty())
+		{
+			FrameVector remaps;
+			std::swap(remaps, d_remaps);
+
+			for(Frame* frame : remaps)
+				if(frame->mapped())
+					this->unmap(*frame);
+
+			// mapping in index order guarantees every preceding frame is already in place
+			auto goesBefore = [](Frame* a, Frame* b) { return a->widget()->index() < b->widget()->index(); };
+			std::sort(remaps.begin(), remaps.end(), goesBefore);
+			remaps.erase(std::unique(remaps.begin(), remaps.end()), remaps.end());
+
+			for(Frame* frame : remaps)
+				this->map(*frame);
+
+			if(!descendants)
+				for(Frame* frame : remaps)
+					frame->remap();
+		}
+
+		if(descendants)
+			for(Widget* widget : d_widget->as<Wedge>().contents())
+				widget->frame().remap();
+	}
+
+	void Stripe::markRemap(Frame& frame)
+	{
+		d_remaps.push_back(&frame);
+		this->markDirty(DIRTY_STRUCTURE);
+		if(d_parent)
+			d_parent->markDescendantDirty(DIRTY_MAPPING);
+	}
+
+	void Stripe::unmarkRemap(Frame& frame)
+	{
+		if(!d_remaps.empty())
+			d_remaps.erase(std::remove(d_remaps.begin(), d_remaps.end(), &frame), d_remaps.end());
+	}
+
+	void Stripe::resetMapping()
+	{
+		// batched changes drop the whole mapping at once and rebuild it in a single remap
+		// the frames stay bound meanwhile, only the removed ones are unbound, by their widget
+		this->unmap();
+		d_remaps.clear();
+		this->markDirty(DIRTY_MAPPING);
 	}
 
 	void Stripe::unmap()
@@ -74,6 +163,9 @@ namespace toy
 		if(frame.flow())
 			++d_sequence.size();
 
+		// a frame left unmapped isn't reached when its parent moves meanwhile
+		frame.invalidateAbsolute();
+
 		this->markDirty(DIRTY_STRUCTURE);
 	}
 
@@ -91,23 +183,33 @@ namespace toy
 	{
 		d_sequence.size() = 0;
 		d_contents.clear();
-		this->markDirty(DIRTY_LAYOUT);
+		this->resetIndex();
+		this->markDirty(DIRTY_STRUCTURE);
 	}
 
 	void Stripe::reindex(size_t from)
 	{
 		for(size_t i = from; i < d_contents.size(); ++i)
 			d_contents[i]->setIndex(d_length, i);
+
+		this->resetIndex();
 	}
 
 	void Stripe::move(size_t from, size_t to)
 	{
 		std::swap(d_contents[from], d_contents[to]);
 		this->reindex(from < to ? from : to);
+		this->markDirty(DIRTY_STRUCTURE);
 	}
 
 	Frame* Stripe::before(Frame& frame)
 	{
+		if(d_shownIndexed)
+		{
+			auto it = std::lower_bound(d_shown.begin(), d_shown.end(), frame.dindex(d_length));
+			return it == d_shown.begin() ? nullptr : d_contents[*(it - 1)];
+		}
+
 		int index = frame.dindex(d_length);
 		while(index-- > 0)
 			if(!d_contents[index]->hidden())
@@ -115,6 +217,49 @@ namespace toy
 		return nullptr;
 	}
 
+	Frame* Stripe::frameAfter(Dimension dim, float pos)
+	{
+		auto ending = [dim, pos](Frame& frame) { return frame.dposition(dim) + frame.dsize(dim) > pos; };
+
+		if(dim == d_length && d_offsetsIndexed)
+		{
+			size_t i = std::upper_bound(d_ends.begin(), d_ends.end(), pos) - d_ends.begin();
+			Frame* frame = i < d_ends.size() ? d_contents[d_shown[i]] : nullptr;
+			Frame* prev = i > 0 ? d_contents[d_shown[i - 1]] : nullptr;
+
+			// frames might have moved since the last layout, so the lookup is checked against their actual position
+			if((!frame || ending(*frame)) && (!prev || !ending(*prev)))
+				return frame;
+		}
+
+		for(Frame* frame : d_sequence)
+			if(!frame->hidden() && ending(*frame))
+				return frame;
+
+		return nullptr;
+	}
+
+	Frame* Stripe::frameBefore(Dimension dim, float pos)
+	{
+		auto starting = [dim, pos](Frame& frame) { return frame.dposition(dim) < pos; };
+
+		if(dim == d_length && d_offsetsIndexed)
+		{
+			size_t i = std::lower_bound(d_starts.begin(), d_starts.end(), pos) - d_starts.begin();
+			Frame* frame = i > 0 ? d_contents[d_shown[i - 1]] : nullptr;
+			Frame* next = i < d_starts.size() ? d_contents[d_shown[i]] : nullptr;
+
+			if((!frame || starting(*frame)) && (!next || !starting(*next)))
+				return frame;
+		}
+
+		for(Frame* frame : reverse_adapt(d_sequence))
+			if(!frame->hidden() && starting(*frame))
+				return frame;
+
+		return nullptr;
+	}
+
 	Frame& Stripe::prev(Frame& frame)
 	{
 		return *d_contents.at(frame.dindex(d_length) - 1);
@@ -160,7 +305,7 @@ namespace toy
 
 	void Stripe::measureLayout()
 	{
-		if(d_dirty < DIRTY_CONTENT)
+		if(this->subtreeDirty() < DIRTY_CONTENT)
 			return;
 
 		d_content = DimFloat(0.f, 0.f);
@@ -170,13 +315,21 @@ namespace toy
 		if(d_sequence.size() < 1)
 			Frame::measureLayout();
 
-		for(Frame* pframe : d_contents)
-			this->measure(*pframe);
+		d_shown.clear();
+		d_shownIndexed = true;
+		d_offsetsIndexed = false;
+
+		for(size_t i = 0; i < d_contents.size(); ++i)
+		{
+			this->measure(*d_contents[i]);
+			if(!d_contents[i]->hidden())
+				d_shown.push_back(i);
+		}
 	}
 
 	void Stripe::resizeLayout()
 	{
-		if(d_dirty < DIRTY_LAYOUT)
+		if(this->subtreeDirty() < DIRTY_CONTENT)
 			return;
 
 		this->normalizeSpan();
@@ -187,83 +340,90 @@ namespace toy
 
 	void Stripe::positionLayout()
 	{
-		if(d_dirty < DIRTY_LAYOUT)
+		// frames without a widget offset their contents by their own position
+		bool moved = !d_widget && d_dirty >= DIRTY_ABSOLUTE;
+		if(this->subtreeDirty() < DIRTY_CONTENT && !moved)
 			return;
 
 		for(Frame* pframe : d_contents)
 			this->position(*pframe);
+
+		this->indexOffsets();
 	}
 
-	void Stripe::measure(Frame& frame)
+	void Stripe::indexContents()
 	{
-		frame.measureLayout();
+		d_shown.clear();
+		d_shownIndexed = true;
+
+		for(size_t i = 0; i < d_contents.size(); ++i)
+			if(!d_contents[i]->hidden())
+				d_shown.push_back(i);
+
+		this->indexOffsets();
+	}
 
-		if(frame.hidden() || !frame.sizeflow())
+	void Stripe::indexOffsets()
+	{
+		d_offsetsIndexed = false;
+		d_starts.clear();
+		d_ends.clear();
+
+		if(!d_shownIndexed)
 			return;
 
-		this->measure(frame, d_length);
-		this->measure(frame, d_depth);
+		for(size_t index : d_shown)
+		{
+			if(index >= d_sequence.size())
+				break;
 
-		if(frame.dsizing(d_length) > WRAP)
-			d_contentExpand = true;
+			Frame& frame = *d_contents[index];
+			float start = frame.dposition(d_length);
+			float end = start + frame.dsize(d_length);
 
-#if 0 // DEBUG
-		frame.debugPrintDepth();
-		printf("LAYOUT: %s measured content size %f , %f\n", frame.style().name().c_str(), frame.dcontent(DIM_X), frame.dcontent(DIM_Y));
-#endif
+			// only a sequence laid out in order can be searched
+			if(!d_starts.empty() && (start < d_starts.back() || end < d_ends.back()))
+				return;
+
+			d_starts.push_back(start);
+			d_ends.push_back(end);
+		}
+
+		d_offsetsIndexed = true;
 	}
 
-	void Stripe::measure(Frame& frame, Dimension dim)
+	inline void Stripe::measure(Frame& frame, Dimension dim, bool length, Sizing sizing, bool flow)
 	{
-		if(frame.dsizing(dim) > WRAP)
+		if(sizing > WRAP)
 			return;
 
-		if(dim == d_length && frame.flow())
+		if(length && flow)
 			d_content[dim] += frame.dmeasure(dim) + this->spacing(frame);
 		else
 			d_content[dim] = std::max(d_content[dim], frame.dmeasure(dim));
 
 
-		if(frame.dsizing(dim) > SHRINK || !frame.flow())
+		if(sizing > SHRINK || !flow)
 			return;
 
-		if(dim == d_length && frame.flow())
+		if(length && flow)
 			d_spaceContent[dim] += frame.dmeasure(dim) + this->spacing(frame);
 		else
 			d_spaceContent[dim] = std::max(d_spaceContent[dim], frame.dmeasure(dim));
 	}
 
-	void Stripe::resize(Frame& frame)
+	inline void Stripe::resize(Frame& frame, Dimension dim, bool length, Sizing sizing)
 	{
-		if(frame.hidden())
-			return;
-
-		this->resize(frame, d_length);
-		this->resize(frame, d_depth);
-
-#if 0 // DEBUG
-		frame.debugPrintDepth();
-		printf("LAYOUT: %s resize size %f , %f\n", frame.style().name().c_str(), frame.dsize(DIM_X), frame.dsize(DIM_Y));
-#endif
-
-		frame.content().updateContentSize();
-
-		frame.resizeLayout();
-	}
-
-	void Stripe::resize(Frame& frame, Dimension dim)
-	{
-		if(d_style->layout().layout()[dim] < AUTO_SIZE)
+		if(d_style->layout().layout()[dim] < AUTO_SIZE || sizing < SHRINK)
 			return;
 
 		float space = this->dspace(dim);
-		if(dim == d_length)
+		if(length)
 			space = (space - d_spaceContent[dim]) * frame.dspan(d_length);
 
 		float content = frame.dcontent(dim) + frame.dpadding(dim) + frame.dbackpadding(dim);
 		float expand = std::max(0.f, space - content);
 
-		Sizing sizing = frame.dsizing(dim);
 		if(sizing == SHRINK)
 			frame.setSizeDim(dim, content);
 		else if(sizing == WRAP)
@@ -272,37 +432,173 @@ namespace toy
 			frame.setSizeDim(dim, space);
 	}
 
-	void Stripe::position(Frame& frame)
+	inline void Stripe::position(Frame& frame, Dimension dim, bool length, bool flow)
 	{
+		if(d_style->layout().layout()[dim] < AUTO_LAYOUT)
+			return;
+
+		float offset = frame.widget() ? this->doffset(dim) : 0.f;
+		float space = this->dspace(dim);
+
+		if(length && flow)
+			frame.setPositionDim(dim, this->positionSequence(frame, offset, d_contentExpand ? 0.f : space - d_content[d_length]));
+		else
+			frame.setPositionDim(dim, this->positionFree(frame, dim, offset, space));
+	}
+
+	template <Dimension Length, Sizing LengthSizing, Sizing DepthSizing, Flow FrameFlow>
+	void Stripe::measureKernel(Frame& frame)
+	{
+		if(FrameFlow > OVERLAY)
+			return;
+
+		this->measure(frame, Length, true, LengthSizing, FrameFlow == FLOW);
+		this->measure(frame, Length == DIM_X ? DIM_Y : DIM_X, false, DepthSizing, FrameFlow == FLOW);
+
+		if(LengthSizing > WRAP)
+			d_contentExpand = true;
+	}
+
+	template <Dimension Length, Sizing LengthSizing, Sizing DepthSizing>
+	void Stripe::resizeKernel(Frame& frame)
+	{
+		this->resize(frame, Length, true, LengthSizing);
+		this->resize(frame, Length == DIM_X ? DIM_Y : DIM_X, false, DepthSizing);
+	}
+
+	template <Dimension Length, Flow FrameFlow>
+	void Stripe::positionKernel(Frame& frame)
+	{
+		if(FrameFlow > ALIGN)
+			return;
+
+		this->position(frame, Length, true, FrameFlow == FLOW);
+		this->position(frame, Length == DIM_X ? DIM_Y : DIM_X, false, FrameFlow == FLOW);
+	}
+
+	namespace
+	{
+		// fixed and manual frames lay out the same way, so kernels only distinguish four sizings
+		constexpr Sizing c_kernelSizings[4] = { FIXED, SHRINK, WRAP, EXPAND };
+	}
+
+	template <Dimension Length, size_t Kernel>
+	Stripe::LayoutKernel Stripe::makeKernel()
+	{
+		constexpr Sizing sizingX = c_kernelSizings[Kernel / 16];
+		constexpr Sizing sizingY = c_kernelSizings[(Kernel / 4) % 4];
+		constexpr Flow flow = Flow(Kernel % 4);
+
+		constexpr Sizing lengthSizing = Length == DIM_X ? sizingX : sizingY;
+		constexpr Sizing depthSizing = Length == DIM_X ? sizingY : sizingX;
+
+		return { &Stripe::measureKernel<Length, lengthSizing, depthSizing, flow>,
+				 &Stripe::resizeKernel<Length, lengthSizing, depthSizing>,
+				 &Stripe::positionKernel<Length, flow> };
+	}
+
+	template <Dimension Length, size_t... Kernels>
+	Stripe::KernelTable Stripe::makeKernels(std::index_sequence<Kernels...>)
+	{
+		return {{ makeKernel<Length, Kernels>()... }};
+	}
+
+	const Stripe::KernelTable Stripe::s_kernels[2] = { makeKernels<DIM_X>(std::make_index_sequence<64>()), makeKernels<DIM_Y>(std::make_index_sequence<64>()) };
+
+	void Stripe::measure(Frame& frame)
+	{
+		++t_layoutVisits;
+
+		// clean frames keep the content size of the previous measure
+		if(frame.subtreeDirty() >= DIRTY_CONTENT && !frame.measureCached() && !this->deferred(frame))
+		{
+			frame.measureLayout();
+			frame.cacheMeasure();
+		}
+
 		if(frame.hidden())
 			return;
 
-		if(frame.posflow())
+		if(s_layoutKernels)
 		{
-			this->position(frame, d_length);
-			this->position(frame, d_depth);
+			(this->*s_kernels[d_length][frame.kernel()].measure)(frame);
 		}
+		else if(frame.sizeflow())
+		{
+			this->measure(frame, d_length, true, frame.dsizing(d_length), frame.flow());
+			this->measure(frame, d_depth, false, frame.dsizing(d_depth), frame.flow());
 
-		frame.positionLayout();
+			if(frame.dsizing(d_length) > WRAP)
+				d_contentExpand = true;
+		}
 
 #if 0 // DEBUG
 		frame.debugPrintDepth();
-		printf("LAYOUT: %s layout position %f , %f\n", frame.style().name().c_str(), frame.dposition(DIM_X), frame.dposition(DIM_Y));
+		printf("LAYOUT: %s measured content size %f , %f\n", frame.style().name().c_str(), frame.dcontent(DIM_X), frame.dcontent(DIM_Y));
 #endif
 	}
 
-	void Stripe::position(Frame& frame, Dimension dim)
+	void Stripe::resize(Frame& frame)
 	{
-		if(d_style->layout().layout()[dim] < AUTO_LAYOUT)
+		++t_layoutVisits;
+
+		if(frame.hidden())
 			return;
 
-		float offset = frame.widget() ? this->doffset(dim) : 0.f;
-		float space = this->dspace(dim);
+		if(s_layoutKernels)
+		{
+			(this->*s_kernels[d_length][frame.kernel()].resize)(frame);
+		}
+		else
+		{
+			this->resize(frame, d_length, true, frame.dsizing(d_length));
+			this->resize(frame, d_depth, false, frame.dsizing(d_depth));
+		}
 
-		if(dim == d_length && frame.flow())
-			frame.setPositionDim(dim, this->positionSequence(frame, offset, d_contentExpand ? 0.f : space - d_content[d_length]));
+#if 0 // DEBUG
+		frame.debugPrintDepth();
+		printf("LAYOUT: %s resize size %f , %f\n", frame.style().name().c_str(), frame.dsize(DIM_X), frame.dsize(DIM_Y));
+#endif
+
+		if(frame.subtreeDirty() < DIRTY_CONTENT || frame.resizeCached())
+			return;
+
+		frame.content().updateContentSize();
+
+		if(this->deferred(frame))
+			t_deferred->push_back(&frame);
 		else
-			frame.setPositionDim(dim, this->positionFree(frame, dim, offset, space));
+			frame.resizeLayout();
+
+		frame.cacheResize();
+	}
+
+	void Stripe::position(Frame& frame)
+	{
+		++t_layoutVisits;
+
+		if(frame.hidden())
+			return;
+
+		if(s_layoutKernels)
+		{
+			(this->*s_kernels[d_length][frame.kernel()].position)(frame);
+		}
+		else if(frame.posflow())
+		{
+			this->position(frame, d_length, true, frame.flow());
+			this->position(frame, d_depth, false, frame.flow());
+		}
+
+		if(this->deferred(frame))
+			t_deferred->push_back(&frame);
+		else
+			frame.positionLayout();
+
+#if 0 // DEBUG
+		frame.debugPrintDepth();
+		printf("LAYOUT: %s layout position %f , %f\n", frame.style().name().c_str(), frame.dposition(DIM_X), frame.dposition(DIM_Y));
+#endif
 	}
 
 	float Stripe::positionFree(Frame& frame, Dimension dim, float offset, float space)
@@ -331,6 +627,14 @@ namespace toy
 		if(this->hidden() || this->hollow() || (this->clip() && !this->inside(x, y)))
 			return nullptr;
 
+		// the layer already tried its sublayers before its own frames
+		Layer& layer = this->layer();
+		if(Layer::s_hitIndex && layer.subtreeDirty() < DIRTY_ABSOLUTE && layer.hitIndex().indexed(*this))
+		{
+			Frame* target = layer.hitIndex().pinpoint(*this, x, y, filter, this != &layer);
+			return target ? target : Frame::pinpoint(x, y, filter);
+		}
+
 		if(!this->widget())
 		{
 			x += this->left();
@@ -375,35 +679,77 @@ namespace toy
 				frame->setSpanDimDirect(d_length, frame->dspan(d_length) / span);
 	}
 
+	bool Stripe::shownRange(float start, float end, size_t& first, size_t& last)
+	{
+		if(!d_offsetsIndexed)
+			return false;
+
+		first = std::upper_bound(d_ends.begin(), d_ends.end(), start) - d_ends.begin();
+		last = std::lower_bound(d_starts.begin(), d_starts.end(), end) - d_starts.begin();
+		last = std::max(first, last);
+
+		// frames might have moved since the last layout, the frames just outside the range are checked against their actual position
+		Frame* before = first > 0 ? d_contents[d_shown[first - 1]] : nullptr;
+		Frame* after = last < d_starts.size() ? d_contents[d_shown[last]] : nullptr;
+		if(before && before->dposition(d_length) + before->dsize(d_length) > start)
+			return false;
+		if(after && after->dposition(d_length) < end)
+			return false;
+
+		return true;
+	}
+
 	float Stripe::nextOffset(Dimension dim, float pos)
 	{
 		pos -= d_position[dim];
 
-		for(Frame* frame : d_sequence)
-			if(frame->dposition(dim) + frame->dsize(dim) > pos)
-			{
-				if(frame->frameType() >= STRIPE)
-					return d_position[dim] + frame->as<Stripe>().nextOffset(dim, pos);
-				else
-					return d_position[dim] + frame->dposition(dim) + frame->dsize(dim);
-			}
-
-		return d_position[dim] + d_size[dim];
+		Frame* frame = this->frameAfter(dim, pos);
+		if(!frame)
+			return d_position[dim] + d_size[dim];
+		else if(frame->frameType() >= STRIPE)
+			return d_position[dim] + frame->as<Stripe>().nextOffset(dim, pos);
+		else
+			return d_position[dim] + frame->dposition(dim) + frame->dsize(dim);
 	}
 
 	float Stripe::prevOffset(Dimension dim, float pos)
 	{
 		pos -= d_position[dim];
 
-		for(Frame* frame : reverse_adapt(d_sequence))
-			if(frame->dposition(dim) < pos)
+		Frame* frame = this->frameBefore(dim, pos);
+		if(!frame)
+			return d_position[dim];
+		else if(frame->frameType() >= STRIPE)
+			return d_position[dim] + frame->as<Stripe>().prevOffset(dim, pos);
+		else
+			return d_position[dim] + frame->dposition(dim);
+	}
+
+	float Stripe::stepOffset(Dimension dim, float pos, int steps)
+	{
+		if(dim == d_length && d_offsetsIndexed && !d_starts.empty())
+		{
+			if(steps > 0)
+			{
+				size_t i = std::upper_bound(d_ends.begin(), d_ends.end(), pos) - d_ends.begin();
+				return std::max(pos, d_ends[std::min(i + steps - 1, d_ends.size() - 1)]);
+			}
+			else if(steps < 0)
 			{
-				if(frame->frameType() >= STRIPE)
-					return d_position[dim] + frame->as<Stripe>().prevOffset(dim, pos);
-				else
-					return d_position[dim] + frame->dposition(dim);
+				size_t i = std::lower_bound(d_starts.begin(), d_starts.end(), pos) - d_starts.begin();
+				return std::min(pos, d_starts[i > size_t(-steps) ? i - size_t(-steps) : 0]);
 			}
+			return pos;
+		}
 
-		return d_position[dim];
+		float offset = pos;
+		for(int step = 0; step < std::abs(steps); ++step)
+		{
+			Frame* frame = steps > 0 ? this->frameAfter(dim, offset) : this->frameBefore(dim, offset);
+			if(!frame)
+				break;
+			offset = steps > 0 ? frame->dposition(dim) + frame->dsize(dim) : frame->dposition(dim);
+		}
+		return offset;
 	}
 }
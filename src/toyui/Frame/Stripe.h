@@ -10,6 +10,8 @@
 
 /* std */
 #include <vector>
+#include <array>
+#include <utility>
 
 namespace toy
 {
@@ -49,6 +51,12 @@ namespace toy
 		virtual void remap();
 		virtual void unmap();
 
+		void markRemap(Frame& frame);
+		void unmarkRemap(Frame& frame);
+		void resetMapping();
+
+		void resetIndex() { d_shownIndexed = false; d_offsetsIndexed = false; }
+
 		void append(Frame& frame);
 		void insert(Frame& frame, size_t index);
 		void remove(Frame& frame);
@@ -58,6 +66,8 @@ namespace toy
 		void move(size_t from, size_t to);
 
 		Frame* before(Frame& frame);
+		Frame* frameAfter(Dimension dim, float pos);
+		Frame* frameBefore(Dimension dim, float pos);
 		Frame& prev(Frame& frame);
 		Frame& next(Frame& frame);
 		bool first(Frame& frame);
@@ -82,14 +92,56 @@ namespace toy
 		float nextOffset(Dimension dim, float pos);
 		float prevOffset(Dimension dim, float pos);
 
+		// boundary of the visible frame a number of steps away from a position : frame ends forward, frame starts backward
+		float stepOffset(Dimension dim, float pos, int steps);
+
+		// range of the shown sequence overlapping a span along the length, as indices in shown(), false when it can't be searched
+		const std::vector<size_t>& shown() { return d_shown; }
+		bool shownRange(float start, float end, size_t& first, size_t& last);
+
+		// indexes the shown contents and their offsets again, for layouts that don't go through the stripe passes
+		void indexContents();
+
 		Frame* pinpoint(float x, float y, const Filter& filter);
 
 		void transferPixelSpan(Frame& prev, Frame& next, float pixelSpan);
 
+		static size_t& layoutVisits();
+		static void deferSublayers(Layer* layer, FrameVector* deferred);
+
+		static bool s_layoutKernels;
+
 	private:
-		void measure(Frame& frame, Dimension dim);
-		void resize(Frame& frame, Dimension dim);
-		void position(Frame& frame, Dimension dim);
+		bool deferred(Frame& frame);
+		void indexOffsets();
+
+		void measure(Frame& frame, Dimension dim, bool length, Sizing sizing, bool flow);
+		void resize(Frame& frame, Dimension dim, bool length, Sizing sizing);
+		void position(Frame& frame, Dimension dim, bool length, bool flow);
+
+		// per child layout kernels, specialized on the length of the stripe, the sizing of the child along length and depth, and its flow
+		struct LayoutKernel
+		{
+			void (Stripe::*measure)(Frame& frame);
+			void (Stripe::*resize)(Frame& frame);
+			void (Stripe::*position)(Frame& frame);
+		};
+
+		typedef std::array<LayoutKernel, 64> KernelTable;
+
+		template <Dimension Length, Sizing LengthSizing, Sizing DepthSizing, Flow FrameFlow>
+		void measureKernel(Frame& frame);
+		template <Dimension Length, Sizing LengthSizing, Sizing DepthSizing>
+		void resizeKernel(Frame& frame);
+		template <Dimension Length, Flow FrameFlow>
+		void positionKernel(Frame& frame);
+
+		template <Dimension Length, size_t Kernel>
+		static LayoutKernel makeKernel();
+		template <Dimension Length, size_t... Kernels>
+		static KernelTable makeKernels(std::index_sequence<Kernels...>);
+
+		static const KernelTable s_kernels[2];
 
 		float positionFree(Frame& frame, Dimension dim, float offset, float space);
 		float positionSequence(Frame& frame, float offset, float space);
@@ -97,6 +149,14 @@ namespace toy
 	protected:
 		FrameVector d_contents;
 		FlowSequence d_sequence;
+		FrameVector d_remaps;
+
+		// visible contents and the extent of the visible sequence along the length, rebuilt by the measure and position passes
+		std::vector<size_t> d_shown;
+		std::vector<float> d_starts;
+		std::vector<float> d_ends;
+		bool d_shownIndexed;
+		bool d_offsetsIndexed;
 	};
 }
 
@@ -32,6 +32,8 @@ namespace toy
 		inline float dsize(Dimension dim) { return d_size[dim]; }
 		inline float dcontent(Dimension dim) { return d_content[dim]; }
 		inline float dspan(Dimension dim) { return d_span[dim]; }
+		inline float dspaceContent(Dimension dim) { return d_spaceContent[dim]; }
+		inline bool contentExpand() { return d_contentExpand; }
 
 		inline float dpadding(Dimension dim) { return d_style->layout().padding()[dim]; }
 		inline float dbackpadding(Dimension dim) { return d_style->layout().padding()[dim + 2]; }
@@ -75,6 +77,7 @@ namespace toy
 		inline void setOpacity(Opacity opacity) { d_opacity = opacity; }
 		inline void setScale(float scale) { d_scale = scale; }
 		inline void setContentSize(DimFloat content) { d_content = content; }
+		inline void setSpaceContent(DimFloat content, bool expand) { d_spaceContent = content; d_contentExpand = expand; }
 
 	protected:
 		DimFloat d_position;
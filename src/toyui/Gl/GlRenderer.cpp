@@ -23,6 +23,7 @@
 #endif
 
 #include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
 
 namespace toy
 {
@@ -30,11 +31,25 @@ namespace toy
 		: NanoRenderer(resourcePath)
 		, m_clear(clear)
 		, m_clock()
+#ifdef TOYUI_DRAW_CACHE
+		, m_targetFramebuffer(0)
+		, m_targetViewport{ 0, 0, 0, 0 }
+#endif
 	{}
 
 	GlRenderer::~GlRenderer()
 	{}
 
+	unique_ptr<RenderTarget> GlRenderer::createRenderTarget(MasterLayer& masterLayer)
+	{
+		unique_ptr<RenderTarget> target = make_unique<RenderTarget>(*this, masterLayer, false);
+#ifndef TOY_PLATFORM_EMSCRIPTEN
+		// a framebuffer we clear ourselves keeps its content between frames, unlike a canvas
+		target->setPartialRedraw(m_clear);
+#endif
+		return target;
+	}
+
 	void GlRenderer::setupContext()
 	{
 		this->initGlew();
@@ -56,6 +71,16 @@ namespace toy
 
 	void GlRenderer::releaseContext()
 	{
+#ifdef TOYUI_DRAW_CACHE
+		for(auto& kv : m_layers)
+			if(kv.second.framebuffer)
+			{
+				nvgluDeleteFramebuffer((NVGLUframebuffer*)kv.second.framebuffer);
+				kv.second.framebuffer = nullptr;
+				kv.second.textured = false;
+			}
+#endif
+
 #if NANOVG_GL2
 		nvgDeleteGL2(m_ctx);
 #elif NANOVG_GL3
@@ -91,8 +116,13 @@ namespace toy
 
 		if(m_clear)
 		{
+			// only the area being redrawn is cleared, the rest of the framebuffer keeps the previous image
+			const BoxFloat& redraw = target.redrawRect();
+			glEnable(GL_SCISSOR_TEST);
+			glScissor(GLint(redraw.x()), GLint(target.layer().height() - redraw.y() - redraw.h()), GLsizei(redraw.w()), GLsizei(redraw.h()));
 			glClearColor(0.f, 0.f, 0.f, 1.0f);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+			glDisable(GL_SCISSOR_TEST);
 		}
 
 		NanoRenderer::render(target);
@@ -101,6 +131,47 @@ namespace toy
 			glEnable(GL_FRAMEBUFFER_SRGB);
 	}
 
+#ifdef TOYUI_DRAW_CACHE
+	bool GlRenderer::beginLayerTexture(LayerSegments& layer, int width, int height)
+	{
+		// plain GL3 framebuffer objects, which software rasterizers like llvmpipe provide as well
+		if(!layer.framebuffer || layer.width != width || layer.height != height)
+		{
+			if(layer.framebuffer)
+				nvgluDeleteFramebuffer((NVGLUframebuffer*)layer.framebuffer);
+
+			NVGLUframebuffer* framebuffer = nvgluCreateFramebuffer(m_ctx, width, height, NVG_IMAGE_FLIPY | NVG_IMAGE_PREMULTIPLIED);
+			layer.framebuffer = framebuffer;
+			if(!framebuffer)
+			{
+				printf("ERROR: Could not create a framebuffer of %i x %i to cache a layer.\n", width, height);
+				return false;
+			}
+
+			layer.image = framebuffer->image;
+			layer.width = width;
+			layer.height = height;
+		}
+
+		// the framebuffer and viewport the target is rendered to are restored once the texture is done
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_targetFramebuffer);
+		glGetIntegerv(GL_VIEWPORT, m_targetViewport);
+
+		nvgluBindFramebuffer((NVGLUframebuffer*)layer.framebuffer);
+		glViewport(0, 0, width, height);
+		glClearColor(0.f, 0.f, 0.f, 0.f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		return true;
+	}
+
+	void GlRenderer::endLayerTexture(RenderTarget& target)
+	{
+		UNUSED(target);
+		glBindFramebuffer(GL_FRAMEBUFFER, GLuint(m_targetFramebuffer));
+		glViewport(m_targetViewport[0], m_targetViewport[1], m_targetViewport[2], m_targetViewport[3]);
+	}
+#endif
+
 	void GlRenderer::logFPS()
 	{
 		static size_t frames = 0;
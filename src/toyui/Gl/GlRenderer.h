@@ -22,6 +22,9 @@ namespace toy
 		virtual void setupContext();
 		virtual void releaseContext();
 
+		// targets
+		virtual unique_ptr<RenderTarget> createRenderTarget(MasterLayer& masterLayer);
+
 		void render(RenderTarget& target);
 
 		void logFPS();
@@ -29,9 +32,19 @@ namespace toy
 	protected:
 		void initGlew();
 
+#ifdef TOYUI_DRAW_CACHE
+		virtual bool beginLayerTexture(LayerSegments& layer, int width, int height);
+		virtual void endLayerTexture(RenderTarget& target);
+#endif
+
 	protected:
 		bool m_clear;
 		Clock m_clock;
+
+#ifdef TOYUI_DRAW_CACHE
+		int m_targetFramebuffer;
+		int m_targetViewport[4];
+#endif
 	};
 
 
@@ -10,6 +10,7 @@
 #include <toyui/Widget/Cursor.h>
 
 #include <cassert>
+#include <algorithm>
 
 namespace toy
 {
@@ -27,7 +28,7 @@ namespace toy
 	void Keyboard::nextFrame()
 	{}
 
-	void Keyboard::dispatchKeyPressed(KeyCode key, char c)
+	void Keyboard::dispatchKeyPressed(KeyCode key, char c, double time)
 	{
 		/*if(key == KC_ESCAPE)
 			m_shutdownRequested = true;
@@ -37,10 +38,11 @@ namespace toy
 			m_ctrlPressed = true;
 
 		KeyDownEvent keyEvent(key, c);
+		keyEvent.time = time;
 		m_rootFrame.dispatchEvent(keyEvent);
 	}
 
-	void Keyboard::dispatchKeyReleased(KeyCode key, char c)
+	void Keyboard::dispatchKeyReleased(KeyCode key, char c, double time)
 	{
 		if(key == KC_LSHIFT || key == KC_RSHIFT)
 			m_shiftPressed = false;
@@ -48,6 +50,7 @@ namespace toy
 			m_ctrlPressed = false;
 
 		KeyUpEvent keyEvent(key, c);
+		keyEvent.time = time;
 		m_rootFrame.dispatchEvent(keyEvent);
 	}
 
@@ -58,37 +61,63 @@ namespace toy
 		, m_middleButton(*this, DEVICE_MOUSE_MIDDLE_BUTTON)
 		, m_lastX(0.f)
 		, m_lastY(0.f)
+		, m_allocations(0)
 	{}
 
 	void Mouse::nextFrame()
 	{
 	}
 
-	void Mouse::mouseFocus(float x, float y, std::vector<Widget*>& focused)
+	void Mouse::mouseFocus(float x, float y, std::vector<Widget*>& focused, double time)
 	{
 		if(focused.size() > 0)
 			m_rootSheet.cursor().hover(*focused.front());
 		else
 			m_rootSheet.cursor().unhover();
 
-		std::sort(m_focused.begin(), m_focused.end());
-		std::sort(focused.begin(), focused.end());
+		// the focused set is kept sorted by handle, so entered and left widgets each come out of a single merge walk
+		auto goesBefore = [](Widget* a, Widget* b) { return a->handle() < b->handle(); };
+		std::sort(focused.begin(), focused.end(), goesBefore);
 
-		MouseEnterEvent mouseEnterEvent(x, y);
-		this->transformMouseEvent(mouseEnterEvent);
+		auto sameFocus = [](Widget* widget, const ReceiverHandle& handle) { return widget->handle() == handle; };
+		if(focused.size() != m_focused.size() || !std::equal(focused.begin(), focused.end(), m_focused.begin(), sameFocus))
+		{
+			MouseEnterEvent mouseEnterEvent(x, y);
+			this->transformMouseEvent(mouseEnterEvent);
+			mouseEnterEvent.time = time;
+
+			MouseLeaveEvent mouseLeaveEvent(x, y);
+			this->transformMouseEvent(mouseLeaveEvent);
+			mouseLeaveEvent.time = time;
 
-		MouseLeaveEvent mouseLeaveEvent(x, y);
-		this->transformMouseEvent(mouseLeaveEvent);
+			auto oldFocus = m_focused.begin();
+			for(Widget* newFocus : focused)
+			{
+				while(oldFocus != m_focused.end() && *oldFocus < newFocus->handle())
+					++oldFocus;
+				if(oldFocus == m_focused.end() || *oldFocus != newFocus->handle())
+					newFocus->receiveEvent(mouseEnterEvent);
+			}
 
-		for(Widget* newFocus : focused)
-			if(std::find(m_focused.begin(), m_focused.end(), newFocus) == m_focused.end())
-				newFocus->receiveEvent(mouseEnterEvent);
+			// widgets destroyed or detached since they were focused are dropped silently
+			auto newFocus = focused.begin();
+			for(const ReceiverHandle& oldFocus : m_focused)
+			{
+				while(newFocus != focused.end() && (*newFocus)->handle() < oldFocus)
+					++newFocus;
+				InputReceiver* receiver = oldFocus.live();
+				if(receiver && (newFocus == focused.end() || (*newFocus)->handle() != oldFocus))
+					receiver->receiveEvent(mouseLeaveEvent);
+			}
+		}
 
-		for(Widget* oldFocus : m_focused)
-			if(std::find(focused.begin(), focused.end(), oldFocus) == focused.end())
-				oldFocus->receiveEvent(mouseLeaveEvent);
+		size_t capacity = m_focused.capacity();
+		m_focused.clear();
+		for(Widget* widget : focused)
+			m_focused.push_back(widget->handle());
 
-		m_focused = focused;
+		if(m_focused.capacity() != capacity)
+			++m_allocations;
 	}
 
 	void Mouse::transformMouseEvent(MouseEvent& mouseEvent)
@@ -99,79 +128,67 @@ namespace toy
 		mouseEvent.deltaY = mouseEvent.posY - m_lastY;
 	}
 
-	void Mouse::dispatchMouseMoved(float x, float y)
+	void Mouse::dispatchMouseMoved(float x, float y, double time)
 	{
 		MouseMoveEvent mouseEvent(x, y);
 		this->transformMouseEvent(mouseEvent);
+		mouseEvent.time = time;
 
 		m_lastX = mouseEvent.posX;
 		m_lastY = mouseEvent.posY;
 
 		m_rootSheet.cursor().setPosition(mouseEvent.posX, mouseEvent.posY);
 
+		size_t capacity = m_hovered.capacity();
+		m_hovered.clear();
+		mouseEvent.visited = &m_hovered;
+
 		m_rootFrame.dispatchEvent(mouseEvent);
 
-		this->mouseFocus(x, y, mouseEvent.visited);
+		if(m_hovered.capacity() != capacity)
+			++m_allocations;
+
+		this->mouseFocus(x, y, m_hovered, time);
 
 		m_leftButton.mouseMoved(mouseEvent);
 		m_rightButton.mouseMoved(mouseEvent);
 		m_middleButton.mouseMoved(mouseEvent);
 	}
 
-	void Mouse::dispatchMousePressed(float x, float y, MouseButtonCode button)
+	void Mouse::dispatchMousePressed(float x, float y, MouseButtonCode button, double time)
 	{
 		if(button == LEFT_BUTTON)
-			m_leftButton.mousePressed(x, y);
+			m_leftButton.mousePressed(x, y, time);
 		else if(button == RIGHT_BUTTON)
-			m_rightButton.mousePressed(x, y);
+			m_rightButton.mousePressed(x, y, time);
 		else if(button == MIDDLE_BUTTON)
-			m_middleButton.mousePressed(x, y);
+			m_middleButton.mousePressed(x, y, time);
 	}
 
-	void Mouse::dispatchMouseReleased(float x, float y, MouseButtonCode button)
+	void Mouse::dispatchMouseReleased(float x, float y, MouseButtonCode button, double time)
 	{
 		if(button == LEFT_BUTTON)
-			m_leftButton.mouseReleased(x, y);
+			m_leftButton.mouseReleased(x, y, time);
 		else if(button == RIGHT_BUTTON)
-			m_rightButton.mouseReleased(x, y);
+			m_rightButton.mouseReleased(x, y, time);
 		else if(button == MIDDLE_BUTTON)
-			m_middleButton.mouseReleased(x, y);
+			m_middleButton.mouseReleased(x, y, time);
 	}
 
-	void Mouse::dispatchMouseWheeled(float x, float y, float amount)
+	void Mouse::dispatchMouseWheeled(float x, float y, float amount, double time)
 	{
 		MouseWheelEvent mouseEvent(x, y, amount);
 		this->transformMouseEvent(mouseEvent);
+		mouseEvent.time = time;
 
 		m_rootFrame.dispatchEvent(mouseEvent);
 	}
 
-	void Mouse::handleBindWidget(Widget& widget)
-	{
-		m_leftButton.handleBindWidget(widget);
-		m_rightButton.handleBindWidget(widget);
-		m_middleButton.handleBindWidget(widget);
-	}
-
-	void Mouse::handleUnbindWidget(Widget& widget)
-	{
-		m_leftButton.handleUnbindWidget(widget);
-		m_rightButton.handleUnbindWidget(widget);
-		m_middleButton.handleUnbindWidget(widget);
-
-		for(int i = m_focused.size() - 1; i >= 0; --i)
-			if(m_focused.at(i) == &widget)
-			{
-				m_rootSheet.cursor().unhover();
-				m_focused.erase(m_focused.begin() + i);
-			}
-	}
-
 	MouseButton::MouseButton(Mouse& mouse, DeviceType deviceType)
 		: InputDevice(mouse.rootSheet())
 		, m_mouse(mouse)
 		, m_deviceType(deviceType)
-		, m_pressed(nullptr)
+		, m_pressed()
 		, m_dragging(false)
 		, m_pressedX(0.f)
 		, m_pressedY(0.f)
@@ -183,7 +200,7 @@ namespace toy
 
 		if(m_dragging)
 			this->dragMove(mouseEvent);
-		else if(m_pressed && (std::abs(mouseEvent.posX - m_pressedX) > threshold
+		else if(this->pressed() && (std::abs(mouseEvent.posX - m_pressedX) > threshold
 						   || std::abs(mouseEvent.posY - m_pressedY) > threshold))
 		{
 			m_dragging = true;
@@ -191,73 +208,63 @@ namespace toy
 		}
 	}
 
-	void MouseButton::mousePressed(float x, float y)
+	void MouseButton::mousePressed(float x, float y, double time)
 	{
 		MousePressEvent mouseEvent(m_deviceType, x, y);
 		m_mouse.transformMouseEvent(mouseEvent);
+		mouseEvent.time = time;
 
-		m_pressed = m_rootFrame.dispatchEvent(mouseEvent);
+		InputReceiver* pressed = m_rootFrame.dispatchEvent(mouseEvent);
+		m_pressed = pressed ? pressed->handle() : ReceiverHandle();
 		m_pressedX = mouseEvent.posX;
 		m_pressedY = mouseEvent.posY;
 	}
 
-	void MouseButton::mouseReleased(float x, float y)
+	void MouseButton::mouseReleased(float x, float y, double time)
 	{
 		MouseReleaseEvent mouseEvent(m_deviceType, x, y);
 		m_mouse.transformMouseEvent(mouseEvent);
+		mouseEvent.time = time;
 
-		m_rootFrame.dispatchEvent(mouseEvent, m_pressed);
+		m_rootFrame.dispatchEvent(mouseEvent, this->pressed());
 
 		if(m_dragging)
 			this->dragEnd(mouseEvent);
 		else
 			this->click(mouseEvent);
 
-		m_pressed = nullptr;
+		m_pressed = ReceiverHandle();
 		m_dragging = false;
 	}
 
 	void MouseButton::dragStart(MouseEvent& mouseEvent)
 	{
 		MouseDragStartEvent dragEvent(m_deviceType, mouseEvent.posX, mouseEvent.posY, m_pressedX, m_pressedY);
-		m_pressed->receiveEvent(dragEvent);
+		dragEvent.time = mouseEvent.time;
+		if(InputReceiver* pressed = this->pressed())
+			pressed->receiveEvent(dragEvent);
 	}
 
 	void MouseButton::dragEnd(MouseEvent& mouseEvent)
 	{
 		MouseDragEndEvent dragEvent(m_deviceType, mouseEvent.posX, mouseEvent.posY);
-		m_pressed->receiveEvent(dragEvent);
+		dragEvent.time = mouseEvent.time;
+		if(InputReceiver* pressed = this->pressed())
+			pressed->receiveEvent(dragEvent);
 	}
 
 	void MouseButton::dragMove(MouseEvent& mouseEvent)
 	{
 		MouseDragEvent dragEvent(m_deviceType, mouseEvent.posX, mouseEvent.posY, mouseEvent.deltaX, mouseEvent.deltaY);
-		m_pressed->receiveEvent(dragEvent);
+		dragEvent.time = mouseEvent.time;
+		if(InputReceiver* pressed = this->pressed())
+			pressed->receiveEvent(dragEvent);
 	}
 
 	void MouseButton::click(MouseEvent& mouseEvent)
 	{
 		MouseClickEvent clickEvent(m_deviceType, mouseEvent.posX, mouseEvent.posY);
-		m_rootFrame.dispatchEvent(clickEvent, m_pressed);
-	}
-
-	void MouseButton::handleUnbindWidget(Widget& widget)
-	{
-		if(m_pressed == &widget)
-		{
-			m_prevPressed = m_pressed;
-			m_pressed = nullptr;
-			m_dragging = false;
-		}
-	}
-	
-	void MouseButton::handleBindWidget(Widget& widget)
-	{
-		if(m_prevPressed == &widget)
-		{
-			m_prevPressed = nullptr;
-			m_pressed = &widget;
-			m_dragging = false;
-		}
+		clickEvent.time = mouseEvent.time;
+		m_rootFrame.dispatchEvent(clickEvent, this->pressed());
 	}
 }
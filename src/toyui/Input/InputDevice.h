@@ -38,8 +38,8 @@ namespace toy
 
 		void nextFrame();
 
-		void dispatchKeyPressed(KeyCode key, char c);
-		void dispatchKeyReleased(KeyCode key, char c);
+		void dispatchKeyPressed(KeyCode key, char c, double time = 0.0);
+		void dispatchKeyReleased(KeyCode key, char c, double time = 0.0);
 
 	protected:
 		bool m_shiftPressed;
@@ -51,28 +51,25 @@ namespace toy
 	public:
 		MouseButton(Mouse& mouse, DeviceType deviceType);
 
-		InputReceiver* pressed() { return m_pressed; }
+		InputReceiver* pressed() { return m_pressed.live(); }
 		float pressedX() { return m_pressedX; }
 		float pressedY() { return m_pressedY; }
 
-		void mousePressed(float x, float y);
+		void mousePressed(float x, float y, double time);
 		void mouseMoved(MouseEvent& mouseEvent);
-		void mouseReleased(float x, float y);
+		void mouseReleased(float x, float y, double time);
 
 		void dragStart(MouseEvent& mouseEvent);
 		void dragEnd(MouseEvent& mouseEvent);
 		void dragMove(MouseEvent& mouseEvent);
 		void click(MouseEvent& mouseEvent);
 
-		void handleUnbindWidget(Widget& widget);
-		void handleBindWidget(Widget& widget);
-
 	protected:
 		Mouse& m_mouse;
 		DeviceType m_deviceType;
 
-		InputReceiver* m_pressed;
-		InputReceiver* m_prevPressed;
+		// a pressed widget moved around the tree keeps receiving its drag, one that is destroyed or detached is skipped
+		ReceiverHandle m_pressed;
 		bool m_dragging;
 
 		float m_pressedX;
@@ -87,19 +84,19 @@ namespace toy
 		float lastX() { return m_lastX; }
 		float lastY() { return m_lastY; }
 
+		// times the hover buffers had to grow, stays put once they fit the deepest hover
+		size_t allocations() { return m_allocations; }
+
 		void nextFrame();
 
 		void transformMouseEvent(MouseEvent& mouseEvent);
 
-		void dispatchMousePressed(float x, float y, MouseButtonCode button);
-		void dispatchMouseMoved(float x, float y);
-		void dispatchMouseReleased(float x, float y, MouseButtonCode button);
-		void dispatchMouseWheeled(float x, float y, float amount);
-
-		void mouseFocus(float x, float y, std::vector<Widget*>& inputFrame);
+		void dispatchMousePressed(float x, float y, MouseButtonCode button, double time = 0.0);
+		void dispatchMouseMoved(float x, float y, double time = 0.0);
+		void dispatchMouseReleased(float x, float y, MouseButtonCode button, double time = 0.0);
+		void dispatchMouseWheeled(float x, float y, float amount, double time = 0.0);
 
-		void handleUnbindWidget(Widget& widget);
-		void handleBindWidget(Widget& widget);
+		void mouseFocus(float x, float y, std::vector<Widget*>& focused, double time = 0.0);
 
 	protected:
 		MouseButton m_leftButton;
@@ -109,14 +106,16 @@ namespace toy
 		float m_lastX;
 		float m_lastY;
 		
-		std::vector<Widget*> m_focused;
+		std::vector<ReceiverHandle> m_focused;
+		std::vector<Widget*> m_hovered;
+		size_t m_allocations;
 	};
 
 	struct TOY_UI_EXPORT KeyDownEvent : public KeyEvent
 	{
 		KeyDownEvent(KeyCode code, char c) : KeyEvent(DEVICE_KEYBOARD, EVENT_PRESSED, code, c) {}
 
-		void dispatch(RootSheet& rootSheet) { rootSheet.keyboard().dispatchKeyPressed(code, c); }
+		void dispatch(RootSheet& rootSheet) { rootSheet.keyboard().dispatchKeyPressed(code, c, time); }
 		void receive(InputReceiver& receiver) { receiver.keyDown(*this); }
 	};
 
@@ -124,7 +123,7 @@ namespace toy
 	{
 		KeyUpEvent(KeyCode code, char c) : KeyEvent(DEVICE_KEYBOARD, EVENT_RELEASED, code, c) {}
 
-		void dispatch(RootSheet& rootSheet) { rootSheet.keyboard().dispatchKeyReleased(code, c); }
+		void dispatch(RootSheet& rootSheet) { rootSheet.keyboard().dispatchKeyReleased(code, c, time); }
 		void receive(InputReceiver& receiver) { receiver.keyUp(*this); }
 	};
 
@@ -132,7 +131,7 @@ namespace toy
 	{
 		KeyCharEvent(KeyCode code, char c) : KeyEvent(DEVICE_KEYBOARD, EVENT_STROKED, code, c) {}
 
-		//void dispatch(RootSheet& rootSheet) { rootSheet.keyboard().dispatchKeyReleased(code, c); }
+		//void dispatch(RootSheet& rootSheet) { rootSheet.keyboard().dispatchKeyReleased(code, c, time); }
 		void receive(InputReceiver& receiver) { receiver.keyStroke(*this); }
 	};
 
@@ -140,7 +139,7 @@ namespace toy
 	{
 		MouseMoveEvent(float x, float y) : MouseEvent(DEVICE_MOUSE, EVENT_MOVED, x, y) {}
 
-		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMouseMoved(posX, posY); }
+		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMouseMoved(posX, posY, time); }
 		void receive(InputReceiver& receiver) { receiver.mouseMoved(*this); }
 	};
 
@@ -148,7 +147,7 @@ namespace toy
 	{
 		MousePressEvent(DeviceType deviceType, float x, float y) : MouseEvent(deviceType, EVENT_PRESSED, x, y) {}
 
-		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMousePressed(posX, posY, button); }
+		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMousePressed(posX, posY, button, time); }
 		void receive(InputReceiver& receiver) { receiver.mousePressed(*this); consumed = true; }
 	};
 
@@ -156,7 +155,7 @@ namespace toy
 	{
 		MouseReleaseEvent(DeviceType deviceType, float x, float y) : MouseEvent(deviceType, EVENT_RELEASED, x, y) {}
 
-		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMouseReleased(posX, posY, button); }
+		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMouseReleased(posX, posY, button, time); }
 		void receive(InputReceiver& receiver) { receiver.mouseReleased(*this); }
 	};
 
@@ -164,7 +163,7 @@ namespace toy
 	{
 		MouseWheelEvent(float x, float y, float amount) : MouseEvent(DEVICE_MOUSE_MIDDLE_BUTTON, EVENT_MOVED, x, y) { deltaZ = amount; }
 
-		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMouseWheeled(posX, posY, deltaZ); }
+		void dispatch(RootSheet& rootSheet) { rootSheet.mouse().dispatchMouseWheeled(posX, posY, deltaZ, time); }
 		void receive(InputReceiver& receiver) { receiver.mouseWheel(*this); }
 	};
 
@@ -9,15 +9,309 @@
 
 #include <toyui/Widget/RootSheet.h>
 #include <toyui/Widget/Sheet.h>
+#include <toyui/Input/InputDevice.h>
+#include <toyui/Input/InputRecorder.h>
+
+#include <chrono>
 
 namespace toy
 {
+	double inputTime()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static size_t ringCapacity(size_t capacity)
+	{
+		size_t size = 1;
+		while(size < capacity)
+			size *= 2;
+		return size;
+	}
+
+	InputQueue::InputQueue(size_t capacity)
+		: m_ring(ringCapacity(capacity))
+		, m_mask(m_ring.size() - 1)
+		, m_head(0)
+		, m_tail(0)
+	{}
+
+	bool InputQueue::push(const InputRecord& record)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if(tail - m_head.load(std::memory_order_acquire) == m_ring.size())
+			return false;
+
+		m_ring[tail & m_mask] = record;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool InputQueue::pop(InputRecord& record)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if(head == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		record = m_ring[head & m_mask];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	InputWindow::InputWindow()
+		: m_recorder(nullptr)
+		, m_replay(nullptr)
+		, m_eventsReceived(0)
+		, m_eventsDispatched(0)
+		, m_eventsDropped(0)
+		, m_ring(1024)
+		, m_threaded(false)
+		, m_pumping(false)
+		, m_cursorX(-1.f)
+		, m_cursorY(-1.f)
+		, m_cursorLatches(0)
+	{}
+
+	InputWindow::~InputWindow()
+	{
+		this->setInputThread(false);
+	}
+
+	void InputWindow::setInputThread(bool enabled)
+	{
+		if(enabled == (m_thread != nullptr))
+			return;
+
+		if(enabled)
+		{
+			m_threaded = true;
+			if(this->threadedPump())
+			{
+				m_pumping = true;
+				m_thread = make_unique<std::thread>([this]() {
+					while(m_pumping)
+					{
+						this->pumpInput();
+						std::this_thread::sleep_for(std::chrono::microseconds(500));
+					}
+				});
+			}
+			else
+			{
+				printf("WARNING: this input backend can only be pumped from the main thread\n");
+				m_threaded = false;
+			}
+		}
+		else
+		{
+			m_pumping = false;
+			m_thread->join();
+			m_thread = nullptr;
+			m_threaded = false;
+		}
+	}
+
+	void InputWindow::queueMouseMoved(float x, float y)
+	{
+		this->queue({ InputRecord::MOUSE_MOVED, x, y, 0.f, NO_BUTTON, KC_UNASSIGNED, 0 });
+	}
+
+	void InputWindow::queueMouseWheeled(float x, float y, float amount)
+	{
+		this->queue({ InputRecord::MOUSE_WHEELED, x, y, amount, NO_BUTTON, KC_UNASSIGNED, 0 });
+	}
+
+	void InputWindow::queueMousePressed(float x, float y, MouseButtonCode button)
+	{
+		this->queue({ InputRecord::MOUSE_PRESSED, x, y, 0.f, button, KC_UNASSIGNED, 0 });
+	}
+
+	void InputWindow::queueMouseReleased(float x, float y, MouseButtonCode button)
+	{
+		this->queue({ InputRecord::MOUSE_RELEASED, x, y, 0.f, button, KC_UNASSIGNED, 0 });
+	}
+
+	void InputWindow::queueKeyPressed(KeyCode key, char c)
+	{
+		this->queue({ InputRecord::KEY_PRESSED, 0.f, 0.f, 0.f, NO_BUTTON, key, c });
+	}
+
+	void InputWindow::queueKeyReleased(KeyCode key, char c)
+	{
+		this->queue({ InputRecord::KEY_RELEASED, 0.f, 0.f, 0.f, NO_BUTTON, key, c });
+	}
+
+	void InputWindow::queue(InputRecord record)
+	{
+		record.time = inputTime();
+
+		if(m_threaded)
+		{
+			if(!m_ring.push(record))
+				++m_eventsDropped;
+			return;
+		}
+
+		this->coalesce(record);
+	}
+
+	void InputWindow::coalesce(const InputRecord& record)
+	{
+		++m_eventsReceived;
+
+		// the mouse computes deltas from its last position, so a merged move carries the whole motion, it keeps the time of the oldest move
+		InputRecord* last = m_events.empty() ? nullptr : &m_events.back();
+		if(last && last->kind == record.kind && record.kind == InputRecord::MOUSE_MOVED)
+		{
+			last->x = record.x;
+			last->y = record.y;
+			return;
+		}
+		else if(last && last->kind == record.kind && record.kind == InputRecord::MOUSE_WHEELED)
+		{
+			last->x = record.x;
+			last->y = record.y;
+			last->amount += record.amount;
+			return;
+		}
+
+		m_events.push_back(record);
+	}
+
+	void InputWindow::dispatchEvents(Mouse& mouse, Keyboard& keyboard)
+	{
+		InputRecord queued;
+		while(m_ring.pop(queued))
+			this->coalesce(queued);
+
+		// handlers might queue events of their own, which wait for the next frame
+		std::swap(m_events, m_dispatching);
+
+		if(m_replay)
+		{
+			// recordings don't store timestamps, replayed events are stamped as they are dispatched
+			m_dispatching.clear();
+			m_replay->frameEvents(m_dispatching);
+			double now = inputTime();
+			for(InputRecord& record : m_dispatching)
+				record.time = now;
+		}
+
+		for(InputRecord& record : m_dispatching)
+		{
+			++m_eventsDispatched;
+
+			if(m_recorder)
+				m_recorder->record(record);
+
+			if(record.kind <= InputRecord::MOUSE_RELEASED)
+			{
+				m_cursorX = record.x;
+				m_cursorY = record.y;
+			}
+
+			switch(record.kind)
+			{
+			case InputRecord::MOUSE_MOVED: mouse.dispatchMouseMoved(record.x, record.y, record.time); break;
+			case InputRecord::MOUSE_WHEELED: mouse.dispatchMouseWheeled(record.x, record.y, record.amount, record.time); break;
+			case InputRecord::MOUSE_PRESSED: mouse.dispatchMousePressed(record.x, record.y, record.button, record.time); break;
+			case InputRecord::MOUSE_RELEASED: mouse.dispatchMouseReleased(record.x, record.y, record.button, record.time); break;
+			case InputRecord::KEY_PRESSED: keyboard.dispatchKeyPressed(record.key, record.c, record.time); break;
+			case InputRecord::KEY_RELEASED: keyboard.dispatchKeyReleased(record.key, record.c, record.time); break;
+			}
+		}
+
+		m_dispatching.clear();
+	}
+
+	bool InputWindow::latchCursor(Mouse& mouse)
+	{
+		float x, y;
+		if(m_replay || !this->sampleCursor(x, y) || (x == m_cursorX && y == m_cursorY))
+			return false;
+
+		// a replay dispatches the latched move at the start of the next frame
+		InputRecord record = { InputRecord::MOUSE_MOVED, x, y, 0.f, NO_BUTTON, KC_UNASSIGNED, 0, inputTime() };
+		if(m_recorder)
+			m_recorder->record(record);
+
+		++m_cursorLatches;
+		m_cursorX = x;
+		m_cursorY = y;
+		mouse.dispatchMouseMoved(x, y, record.time);
+		return true;
+	}
+
+	struct ReceiverSlot
+	{
+		InputReceiver* receiver;
+		uint32_t generation;
+		uint32_t attachment;
+		bool attached;
+	};
+
+	// slot zero stays empty, it is what default handles point to
+	static std::vector<ReceiverSlot>& receiverSlots() { static std::vector<ReceiverSlot> slots = { { nullptr, 0, 0, false } }; return slots; }
+	static std::vector<uint32_t>& freeReceiverSlots() { static std::vector<uint32_t> slots; return slots; }
+
+	// bumped whenever a receiver is bound or unbound, a slot holds the attachment of its receiver as of the value it last saw
+	static uint32_t& attachmentEpoch() { static uint32_t epoch = 1; return epoch; }
+
+	InputReceiver* ReceiverHandle::get() const
+	{
+		const ReceiverSlot& slot = receiverSlots()[index];
+		return slot.generation == generation ? slot.receiver : nullptr;
+	}
+
+	InputReceiver* ReceiverHandle::live() const
+	{
+		InputReceiver* receiver = this->get();
+		if(!receiver)
+			return nullptr;
+
+		ReceiverSlot& slot = receiverSlots()[index];
+		if(slot.attachment != attachmentEpoch())
+		{
+			slot.attached = receiver->attached();
+			slot.attachment = attachmentEpoch();
+		}
+		return slot.attached ? receiver : nullptr;
+	}
+
 	InputReceiver::InputReceiver()
 		: m_controlGraph()
-	{}
+	{
+		std::vector<ReceiverSlot>& slots = receiverSlots();
+		std::vector<uint32_t>& free = freeReceiverSlots();
+		if(free.empty())
+		{
+			slots.push_back({ this, 1, 0, false });
+			m_handle = ReceiverHandle(uint32_t(slots.size() - 1), 1);
+		}
+		else
+		{
+			uint32_t index = free.back();
+			free.pop_back();
+			slots[index].receiver = this;
+			slots[index].attachment = 0;
+			m_handle = ReceiverHandle(index, slots[index].generation);
+		}
+	}
 
 	InputReceiver::~InputReceiver()
-	{}
+	{
+		ReceiverSlot& slot = receiverSlots()[m_handle.index];
+		slot.receiver = nullptr;
+		++slot.generation;
+		freeReceiverSlots().push_back(m_handle.index);
+	}
+
+	void InputReceiver::invalidateAttachment()
+	{
+		// zero is left for slots that never checked
+		if(++attachmentEpoch() == 0)
+			++attachmentEpoch();
+	}
 
 	InputReceiver* InputReceiver::controlEvent(InputEvent& inputEvent)
 	{
@@ -40,6 +334,7 @@ namespace toy
 
 	ControlNode::ControlNode(InputReceiver& receiver, ControlNode* parent, ControlMode mode, DeviceType device)
 		: m_receiver(&receiver)
+		, m_handle(receiver.handle())
 		, m_parent(parent)
 		, m_controlMode(mode)
 		, m_device(device)
@@ -51,7 +346,24 @@ namespace toy
 
 	ControlNode::~ControlNode()
 	{
-		m_receiver->uncontrol();
+		if(InputReceiver* receiver = m_handle.get())
+			receiver->uncontrol();
+	}
+
+	bool ControlNode::live()
+	{
+		return !m_parent || m_handle.live();
+	}
+
+	void ControlNode::prune()
+	{
+		while(m_controller && !m_controller->live())
+		{
+			unique_ptr<ControlNode> controller = std::move(m_controller);
+			m_controller = std::move(controller->m_controller);
+			if(m_controller)
+				m_controller->m_parent = this;
+		}
 	}
 
 	bool ControlNode::controls(DeviceType device)
@@ -83,6 +395,8 @@ namespace toy
 
 	InputReceiver* ControlNode::controlEvent(InputEvent& inputEvent)
 	{
+		this->prune();
+
 		if(m_controller && m_controller->controls(inputEvent.deviceType))
 			return m_controller->controlEvent(inputEvent);
 
@@ -101,7 +415,7 @@ namespace toy
 
 	ControlNode* ControlNode::findReceiver(InputReceiver& receiver)
 	{
-		if(m_receiver == &receiver)
+		if(m_handle == receiver.handle())
 			return this;
 		else if(m_controller)
 			return m_controller->findReceiver(receiver);
@@ -122,8 +436,14 @@ namespace toy
 		if(m_controller)
 			m_controller->yieldControl(receiver);
 
-		if(m_receiver == &receiver)
-			m_parent->m_controller = m_controller ? std::move(m_controller) : nullptr;
+		if(m_handle == receiver.handle())
+		{
+			ControlNode* parent = m_parent;
+			unique_ptr<ControlNode> self = std::move(parent->m_controller);
+			parent->m_controller = std::move(m_controller);
+			if(parent->m_controller)
+				parent->m_controller->m_parent = parent;
+		}
 	}
 
 	ControlSwitch::ControlSwitch(InputReceiver& receiver)
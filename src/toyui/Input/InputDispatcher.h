@@ -12,6 +12,9 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <cstdint>
+#include <thread>
 
 namespace toy
 {
@@ -48,9 +51,13 @@ namespace toy
 		bool consumed;
 		bool abort;
 
-		std::vector<Widget*> visited;
+		// buffer collecting the widgets the event went through, owned by the device and reused from one event to the next
+		std::vector<Widget*>* visited;
 
-		InputEvent(DeviceType deviceType, EventType eventType) : deviceType(deviceType), eventType(eventType), consumed(false), abort(false) {}
+		// seconds on the steady clock when the input causing the event came in, zero for synthetic events
+		double time;
+
+		InputEvent(DeviceType deviceType, EventType eventType) : deviceType(deviceType), eventType(eventType), consumed(false), abort(false), visited(nullptr), time(0.0) {}
 		virtual ~InputEvent() {}
 
 		virtual void dispatch(RootSheet& rootSheet) {}
@@ -95,13 +102,116 @@ namespace toy
 		{}
 	};
 
+	struct TOY_UI_EXPORT InputRecord
+	{
+		enum Kind
+		{
+			MOUSE_MOVED,
+			MOUSE_WHEELED,
+			MOUSE_PRESSED,
+			MOUSE_RELEASED,
+			KEY_PRESSED,
+			KEY_RELEASED
+		};
+
+		Kind kind;
+		float x;
+		float y;
+		float amount;
+		MouseButtonCode button;
+		KeyCode key;
+		char c;
+
+		// seconds on the steady clock when the event came in
+		double time;
+	};
+
+	double inputTime();
+
+	/* Lock-free ring of input records with a single producer, the input thread, and a single consumer, the frame */
+	class TOY_UI_EXPORT InputQueue
+	{
+	public:
+		InputQueue(size_t capacity);
+
+		bool push(const InputRecord& record);
+		bool pop(InputRecord& record);
+
+	protected:
+		std::vector<InputRecord> m_ring;
+		size_t m_mask;
+		std::atomic<size_t> m_head;
+		std::atomic<size_t> m_tail;
+	};
+
 	class TOY_UI_EXPORT InputWindow
 	{
 	public:
+		InputWindow();
+		virtual ~InputWindow();
+
 		virtual bool nextFrame() = 0;
 
 		virtual void initInput(Mouse& mouse, Keyboard& keyboard) = 0;
 		virtual void resize(size_t width, size_t height) = 0;
+
+		// backends which can collect input away from the main thread pump it here
+		virtual bool threadedPump() { return false; }
+		virtual void pumpInput() {}
+
+		// current cursor position, for backends that can read it at any time
+		virtual bool sampleCursor(float& x, float& y) { UNUSED(x); UNUSED(y); return false; }
+
+		size_t eventsReceived() { return m_eventsReceived; }
+		size_t eventsDispatched() { return m_eventsDispatched; }
+		size_t eventsDropped() { return m_eventsDropped; }
+		size_t cursorLatches() { return m_cursorLatches; }
+
+		bool inputThread() { return m_thread != nullptr; }
+
+		// the input thread pumps the backend into a lock-free queue, drained when the frame dispatches events
+		// a backend must stop the thread in its destructor, as it calls back into the backend
+		void setInputThread(bool enabled);
+
+		// events are queued as they come in and dispatched in order once per frame, a move or a wheel right after one of its kind is merged into it
+		void queueMouseMoved(float x, float y);
+		void queueMouseWheeled(float x, float y, float amount);
+		void queueMousePressed(float x, float y, MouseButtonCode button);
+		void queueMouseReleased(float x, float y, MouseButtonCode button);
+		void queueKeyPressed(KeyCode key, char c);
+		void queueKeyReleased(KeyCode key, char c);
+
+		void dispatchEvents(Mouse& mouse, Keyboard& keyboard);
+
+		// moves the mouse to the freshest cursor position, right before rendering
+		bool latchCursor(Mouse& mouse);
+
+		// dispatched events are written to the recorder, a replay takes the place of live input
+		void setRecorder(InputRecorder* recorder) { m_recorder = recorder; }
+		void setReplay(InputReplay* replay) { m_replay = replay; }
+
+	protected:
+		void queue(InputRecord record);
+		void coalesce(const InputRecord& record);
+
+	protected:
+		InputRecorder* m_recorder;
+		InputReplay* m_replay;
+
+		std::vector<InputRecord> m_events;
+		std::vector<InputRecord> m_dispatching;
+		size_t m_eventsReceived;
+		size_t m_eventsDispatched;
+		std::atomic<size_t> m_eventsDropped;
+
+		InputQueue m_ring;
+		unique_ptr<std::thread> m_thread;
+		std::atomic<bool> m_threaded;
+		std::atomic<bool> m_pumping;
+
+		float m_cursorX;
+		float m_cursorY;
+		size_t m_cursorLatches;
 	};
 
 	enum ControlMode
@@ -112,12 +222,40 @@ namespace toy
 		CM_ABSOLUTE
 	};
 
+	/* Weak reference to an input receiver : a slot is reused with a new generation once its receiver is destroyed,
+	   so handles kept by the input devices and the control graph resolve to null instead of dangling */
+	struct TOY_UI_EXPORT ReceiverHandle
+	{
+		uint32_t index;
+		uint32_t generation;
+
+		ReceiverHandle() : index(0), generation(0) {}
+		ReceiverHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+		InputReceiver* get() const;
+
+		// the receiver, if it is still alive and attached to a root sheet : the attachment is kept in the slot,
+		// and checked again only after a receiver was bound or unbound somewhere
+		InputReceiver* live() const;
+
+		bool operator==(const ReceiverHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const ReceiverHandle& other) const { return !(*this == other); }
+		bool operator<(const ReceiverHandle& other) const { return index != other.index ? index < other.index : generation < other.generation; }
+	};
+
 	class TOY_UI_EXPORT InputReceiver
 	{
 	public:
 		InputReceiver();
 		~InputReceiver();
 
+		const ReceiverHandle& handle() const { return m_handle; }
+
+		virtual bool attached() { return true; }
+
+		// the attachment kept in the slots of all the receivers is out of date
+		static void invalidateAttachment();
+
 		virtual InputReceiver* controlEvent(InputEvent& inputEvent);
 		virtual InputReceiver* receiveEvent(InputEvent& inputEvent);
 		virtual InputReceiver* propagateEvent(InputEvent& inputEvent);
@@ -159,6 +297,7 @@ namespace toy
 		virtual void unmodal() {};
 
 	protected:
+		ReceiverHandle m_handle;
 		unique_ptr<ControlNode> m_controlGraph;
 	};
 
@@ -178,6 +317,12 @@ namespace toy
 
 		ControlNode* findReceiver(InputReceiver& receiver);
 
+		// the root node and nodes whose receiver is alive and attached
+		bool live();
+
+		// controllers destroyed or detached since they took control give it back, as if they had yielded
+		void prune();
+
 		void takeControl(InputReceiver& receiver, ControlMode mode, DeviceType device);
 		void yieldControl(InputReceiver& receiver);
 
@@ -185,6 +330,7 @@ namespace toy
 
 	protected:
 		InputReceiver* m_receiver;
+		ReceiverHandle m_handle;
 		ControlNode* m_parent;
 		ControlMode m_controlMode;
 		DeviceType m_device;
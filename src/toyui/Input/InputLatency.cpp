@@ -0,0 +1,141 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Input/InputLatency.h>
+
+#include <toyui/Widget/Widget.h>
+#include <toyui/Style/Style.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace toy
+{
+	InputLatency* InputLatency::s_tracker = nullptr;
+	thread_local InputLatency::Scope* InputLatency::s_scope = nullptr;
+
+	LatencyHistogram::LatencyHistogram()
+		: m_buckets(s_buckets + 1, 0)
+		, m_count(0)
+		, m_max(0.0)
+	{}
+
+	void LatencyHistogram::add(double milliseconds)
+	{
+		size_t last = s_buckets;
+		size_t bucket = std::min(last, size_t(std::max(0.0, milliseconds) / s_resolution));
+		++m_buckets[bucket];
+		++m_count;
+		m_max = std::max(m_max, milliseconds);
+	}
+
+	void LatencyHistogram::clear()
+	{
+		std::fill(m_buckets.begin(), m_buckets.end(), 0);
+		m_count = 0;
+		m_max = 0.0;
+	}
+
+	double LatencyHistogram::percentile(double fraction) const
+	{
+		if(m_count == 0)
+			return 0.0;
+
+		size_t rank = size_t(std::ceil(fraction * m_count));
+		size_t seen = 0;
+		for(size_t bucket = 0; bucket < s_buckets; ++bucket)
+		{
+			seen += m_buckets[bucket];
+			if(seen >= rank)
+				return std::min(m_max, (bucket + 1) * s_resolution);
+		}
+		return m_max;
+	}
+
+	InputLatency::InputLatency()
+	{}
+
+	InputLatency::~InputLatency()
+	{
+		if(s_tracker == this)
+			s_tracker = nullptr;
+	}
+
+	InputLatency::Scope::Scope(InputEvent& inputEvent, Widget& receiver)
+		: m_previous(s_scope)
+		, m_key({ inputEvent.eventType, inputEvent.deviceType, &receiver.style() })
+		, m_time(inputEvent.time)
+		, m_invalidated(false)
+	{
+		// synthetic events carry no time, they are left out
+		if(s_tracker && m_time > 0.0)
+			s_scope = this;
+	}
+
+	InputLatency::Scope::~Scope()
+	{
+		if(s_scope == this)
+			s_scope = m_previous;
+	}
+
+	void InputLatency::Scope::invalidate()
+	{
+		if(m_invalidated || !s_tracker)
+			return;
+
+		m_invalidated = true;
+		s_tracker->m_pending.push_back({ m_key, m_time });
+	}
+
+	string InputLatency::eventName(EventType eventType, DeviceType deviceType)
+	{
+		if(eventType == EVENT_MOVED && deviceType == DEVICE_MOUSE_MIDDLE_BUTTON)
+			return "mouse wheeled";
+
+		string device = deviceType == DEVICE_KEYBOARD ? "key"
+					  : deviceType == DEVICE_MOUSE_LEFT_BUTTON ? "left"
+					  : deviceType == DEVICE_MOUSE_RIGHT_BUTTON ? "right"
+					  : deviceType == DEVICE_MOUSE_MIDDLE_BUTTON ? "middle"
+					  : "mouse";
+
+		static const char* events[] = { "none", "entered", "leaved", "pressed", "released", "moved", "stroked", "dragged", "drag started", "drag ended" };
+		return device + " " + events[eventType];
+	}
+
+	LatencyHistogram* InputLatency::histogram(EventType eventType, DeviceType deviceType, Style* style)
+	{
+		auto it = m_histograms.find({ eventType, deviceType, style });
+		return it != m_histograms.end() ? &it->second : nullptr;
+	}
+
+	void InputLatency::present(double time)
+	{
+		for(Pending& pending : m_pending)
+		{
+			double latency = (time - pending.time) * 1000.0;
+			m_histograms[pending.key].add(latency);
+			m_histograms[{ pending.key.eventType, pending.key.deviceType, nullptr }].add(latency);
+		}
+
+		m_pending.clear();
+	}
+
+	void InputLatency::clear()
+	{
+		m_pending.clear();
+		m_histograms.clear();
+	}
+
+	void InputLatency::report()
+	{
+		for(auto& kv : m_histograms)
+		{
+			const LatencyHistogram& histogram = kv.second;
+			string name = eventName(kv.first.eventType, kv.first.deviceType) + (kv.first.style ? " on " + kv.first.style->name() : "");
+			printf("INFO: input latency, %s : %zu events, p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms\n", name.c_str(), histogram.count(),
+				   histogram.percentile(0.5), histogram.percentile(0.95), histogram.percentile(0.99), histogram.max());
+		}
+	}
+}
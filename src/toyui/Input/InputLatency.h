@@ -0,0 +1,104 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_INPUTLATENCY_H
+#define TOY_INPUTLATENCY_H
+
+/* toy */
+#include <toyobj/String/String.h>
+#include <toyui/Forward.h>
+#include <toyui/Input/InputDispatcher.h>
+
+/* Standards */
+#include <vector>
+#include <map>
+
+namespace toy
+{
+	class TOY_UI_EXPORT LatencyHistogram
+	{
+	public:
+		LatencyHistogram();
+
+		size_t count() const { return m_count; }
+		double max() const { return m_max; }
+
+		void add(double milliseconds);
+		void clear();
+
+		// upper bound of the latency under which the given fraction of the samples fall, in milliseconds
+		double percentile(double fraction) const;
+
+	protected:
+		// tenths of a millisecond up to 250 ms, the last bucket holds the rest
+		static const size_t s_buckets = 2500;
+		static constexpr double s_resolution = 0.1;
+
+		std::vector<size_t> m_buckets;
+		size_t m_count;
+		double m_max;
+	};
+
+	/* The event a widget is receiving is the scope of the invalidations made meanwhile : the first frame marked dirty
+	   in a scope makes the event pending, and the next presented frame records the latency from the input time to the present. */
+	class TOY_UI_EXPORT InputLatency
+	{
+	public:
+		InputLatency();
+		~InputLatency();
+
+		struct Key
+		{
+			EventType eventType;
+			DeviceType deviceType;
+			Style* style;
+
+			bool operator<(const Key& other) const { return eventType != other.eventType ? eventType < other.eventType : deviceType != other.deviceType ? deviceType < other.deviceType : style < other.style; }
+		};
+
+		class TOY_UI_EXPORT Scope
+		{
+		public:
+			Scope(InputEvent& inputEvent, Widget& receiver);
+			~Scope();
+
+			void invalidate();
+
+		protected:
+			Scope* m_previous;
+			Key m_key;
+			double m_time;
+			bool m_invalidated;
+		};
+
+		static void invalidated() { if(s_scope) s_scope->invalidate(); }
+
+		static string eventName(EventType eventType, DeviceType deviceType);
+
+		// latencies of a kind of event, over all receivers, or for the receivers of a style
+		LatencyHistogram* histogram(EventType eventType, DeviceType deviceType, Style* style = nullptr);
+		const std::map<Key, LatencyHistogram>& histograms() { return m_histograms; }
+
+		void present(double time);
+		void clear();
+
+		void report();
+
+		static InputLatency* s_tracker;
+
+	protected:
+		struct Pending
+		{
+			Key key;
+			double time;
+		};
+
+		std::vector<Pending> m_pending;
+		std::map<Key, LatencyHistogram> m_histograms;
+
+		static thread_local Scope* s_scope;
+	};
+}
+
+#endif // TOY_INPUTLATENCY_H
@@ -0,0 +1,181 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Input/InputRecorder.h>
+
+#include <toyui/Input/InputDispatcher.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace toy
+{
+	static const char s_magic[4] = { 'T', 'O', 'Y', 'I' };
+	static const uint8_t s_version = 1;
+	static const uint8_t s_frameTag = 0xFF;
+
+	template <class T>
+	void writeValue(std::ofstream& file, T value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <class T>
+	bool readValue(std::ifstream& file, T& value)
+	{
+		return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	InputRecorder::InputRecorder(const string& path)
+		: m_file(path, std::ios::binary | std::ios::trunc)
+		, m_frames(0)
+	{
+		m_file.write(s_magic, sizeof(s_magic));
+		writeValue<uint8_t>(m_file, s_version);
+	}
+
+	InputRecorder::~InputRecorder()
+	{}
+
+	void InputRecorder::record(const InputRecord& record)
+	{
+		writeValue<uint8_t>(m_file, uint8_t(record.kind));
+
+		switch(record.kind)
+		{
+		case InputRecord::MOUSE_MOVED:
+			writeValue<float>(m_file, record.x);
+			writeValue<float>(m_file, record.y);
+			break;
+		case InputRecord::MOUSE_WHEELED:
+			writeValue<float>(m_file, record.x);
+			writeValue<float>(m_file, record.y);
+			writeValue<float>(m_file, record.amount);
+			break;
+		case InputRecord::MOUSE_PRESSED:
+		case InputRecord::MOUSE_RELEASED:
+			writeValue<float>(m_file, record.x);
+			writeValue<float>(m_file, record.y);
+			writeValue<uint8_t>(m_file, uint8_t(record.button));
+			break;
+		case InputRecord::KEY_PRESSED:
+		case InputRecord::KEY_RELEASED:
+			writeValue<uint8_t>(m_file, uint8_t(record.key));
+			writeValue<char>(m_file, record.c);
+			break;
+		}
+	}
+
+	void InputRecorder::frame(size_t delta)
+	{
+		writeValue<uint8_t>(m_file, s_frameTag);
+		writeValue<uint32_t>(m_file, uint32_t(delta));
+		++m_frames;
+	}
+
+	InputReplay::InputReplay(UiWindow& window, const string& path)
+		: m_window(window)
+		, m_loaded(false)
+		, m_frame(0)
+	{
+		m_loaded = this->load(path);
+
+		m_window.context().inputWindow().setReplay(this);
+		m_window.setFrameClock([this]() { return m_frame < m_frames.size() ? m_frames[m_frame].delta : 0; });
+	}
+
+	InputReplay::~InputReplay()
+	{
+		m_window.context().inputWindow().setReplay(nullptr);
+		m_window.setFrameClock(nullptr);
+	}
+
+	bool InputReplay::load(const string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		char magic[4];
+		uint8_t version;
+		if(!file.read(magic, sizeof(magic)) || memcmp(magic, s_magic, sizeof(magic)) != 0 || !readValue(file, version) || version != s_version)
+		{
+			printf("ERROR: %s is not an input recording\n", path.c_str());
+			return false;
+		}
+
+		size_t begin = 0;
+		uint8_t tag;
+		while(readValue(file, tag))
+		{
+			if(tag == s_frameTag)
+			{
+				uint32_t delta;
+				if(!readValue(file, delta))
+					break;
+				m_frames.push_back({ begin, m_records.size(), delta });
+				begin = m_records.size();
+				continue;
+			}
+
+			InputRecord record = { InputRecord::Kind(tag), 0.f, 0.f, 0.f, NO_BUTTON, KC_UNASSIGNED, 0 };
+			uint8_t button;
+			uint8_t key;
+			bool complete = true;
+
+			switch(record.kind)
+			{
+			case InputRecord::MOUSE_MOVED:
+				complete = readValue(file, record.x) && readValue(file, record.y);
+				break;
+			case InputRecord::MOUSE_WHEELED:
+				complete = readValue(file, record.x) && readValue(file, record.y) && readValue(file, record.amount);
+				break;
+			case InputRecord::MOUSE_PRESSED:
+			case InputRecord::MOUSE_RELEASED:
+				complete = readValue(file, record.x) && readValue(file, record.y) && readValue(file, button);
+				record.button = MouseButtonCode(button);
+				break;
+			case InputRecord::KEY_PRESSED:
+			case InputRecord::KEY_RELEASED:
+				complete = readValue(file, key) && readValue(file, record.c);
+				record.key = KeyCode(key);
+				break;
+			default:
+				complete = false;
+			}
+
+			if(!complete)
+			{
+				printf("ERROR: input recording %s is truncated or corrupted after %zu frames\n", path.c_str(), m_frames.size());
+				break;
+			}
+
+			m_records.push_back(record);
+		}
+
+		// events recorded after the last frame boundary never made it into a frame
+		m_records.resize(begin);
+		return true;
+	}
+
+	bool InputReplay::nextFrame()
+	{
+		if(m_frame >= m_frames.size())
+			return false;
+
+		m_window.nextFrame();
+		m_timings.push_back(m_window.timings());
+		++m_frame;
+		return true;
+	}
+
+	void InputReplay::frameEvents(std::vector<InputRecord>& events)
+	{
+		if(m_frame >= m_frames.size())
+			return;
+
+		const ReplayFrame& frame = m_frames[m_frame];
+		events.insert(events.end(), m_records.begin() + frame.begin, m_records.begin() + frame.end);
+	}
+}
@@ -0,0 +1,80 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_INPUTRECORDER_H
+#define TOY_INPUTRECORDER_H
+
+/* toy */
+#include <toyobj/String/String.h>
+#include <toyui/Forward.h>
+#include <toyui/Input/InputDispatcher.h>
+#include <toyui/UiWindow.h>
+
+/* Standards */
+#include <vector>
+#include <fstream>
+
+namespace toy
+{
+	/* Input streams are stored as a header followed by one byte tagging each entry :
+	   dispatched events carry their coordinates, button or key, frame boundaries carry the clock delta of the frame they end. */
+	class TOY_UI_EXPORT InputRecorder
+	{
+	public:
+		InputRecorder(const string& path);
+		~InputRecorder();
+
+		bool open() { return m_file.is_open(); }
+		size_t frames() { return m_frames; }
+
+		void record(const InputRecord& record);
+		void frame(size_t delta);
+
+	protected:
+		std::ofstream m_file;
+		size_t m_frames;
+	};
+
+	/* Drives a window through a recording : each frame dispatches the recorded events instead of live input,
+	   and advances the window clock by the recorded delta, so that runs of the same recording are identical. */
+	class TOY_UI_EXPORT InputReplay
+	{
+	public:
+		InputReplay(UiWindow& window, const string& path);
+		~InputReplay();
+
+		bool loaded() { return m_loaded; }
+		size_t frames() { return m_frames.size(); }
+		size_t frame() { return m_frame; }
+
+		const std::vector<FrameTimings>& timings() { return m_timings; }
+
+		// runs the next recorded frame, false once the recording is over
+		bool nextFrame();
+
+		void frameEvents(std::vector<InputRecord>& events);
+
+	protected:
+		bool load(const string& path);
+
+		struct ReplayFrame
+		{
+			size_t begin;
+			size_t end;
+			size_t delta;
+		};
+
+	protected:
+		UiWindow& m_window;
+		bool m_loaded;
+
+		std::vector<InputRecord> m_records;
+		std::vector<ReplayFrame> m_frames;
+		size_t m_frame;
+
+		std::vector<FrameTimings> m_timings;
+	};
+}
+
+#endif // TOY_INPUTRECORDER_H
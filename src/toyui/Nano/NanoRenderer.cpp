@@ -12,6 +12,7 @@
 #include <toyui/Frame/Layer.h>
 
 #include <toyui/Widget/Widget.h>
+#include <toyui/Render/DrawFrame.h>
 
 #include <toyui/ImageAtlas.h>
 #include <toyui/UiWindow.h>
@@ -19,6 +20,7 @@
 #include <nanovg.h>
 
 #include <cmath>
+#include <algorithm>
 
 namespace toy
 {
@@ -28,23 +30,26 @@ namespace toy
 		return (v > mx) ? mx : (v < mn) ? mn : v;
 	}
 
-	NVGcolor nvgColour(const Colour& colour)
+	NVGcolor nvgColour(const float* colour)
 	{
-		return nvgRGBAf(colour.r(), colour.g(), colour.b(), colour.a());
+		return nvgRGBAf(colour[0], colour[1], colour[2], colour[3]);
 	}
 
-	NVGcolor nvgOffsetColour(const Colour& colour, float delta)
+	Colour offsetColour(const Colour& colour, float delta)
 	{
 		float offset = delta / 255.0f;
-		return nvgRGBAf(	clamp(colour.r() + offset, 0, 1),
-							clamp(colour.g() + offset, 0, 1),
-							clamp(colour.b() + offset, 0, 1),
-							colour.a());
+		return Colour(	clamp(colour.r() + offset, 0, 1),
+						clamp(colour.g() + offset, 0, 1),
+						clamp(colour.b() + offset, 0, 1),
+						colour.a());
 	}
 
 	NanoRenderer::NanoRenderer(const string& resourcePath)
 		: Renderer(resourcePath)
 		, m_ctx(nullptr)
+#ifdef TOYUI_DRAW_CACHE
+		, m_recording(nullptr)
+#endif
 	{}
 
 	NanoRenderer::~NanoRenderer()
@@ -86,27 +91,56 @@ namespace toy
 	{
 		m_debugBatch = 0;
 		m_debugDepth = 0;
+		m_recordedSegments = 0;
+		m_reusedSegments = 0;
+		m_layerTextures = 0;
+		m_occludedLayers = 0;
+		m_visitedFrames = 0;
+		m_drawnFrames = 0;
+		m_drawCommands = 0;
+		m_drawCalls = 0;
+		m_stateChanges = 0;
+		m_unsortedDrawCalls = 0;
+		m_unsortedStateChanges = 0;
 		Stencil::s_debugBatch = 0;
 		static int prevBatch = 0;
 
 		float pixelRatio = 1.f;
-		nvgBeginFrame(m_ctx, target.layer().width(), target.layer().height(), pixelRatio);
+		bool mapped = target.layer().subtreeDirty() < Frame::DIRTY_MAPPING;
 
-		if(target.layer().dirty() < Frame::DIRTY_MAPPING)
+#ifdef TOYUI_DRAW_CACHE
+		if(mapped)
 		{
-			target.layer().widget()->render(*this, false);
+			// segments don't depend on where their layer is placed, so each layer is updated on its own,
+			// except for those covered by opaque layers above them, which keep their state until they show again
+			this->occludeLayers(target);
+			for(Layer* layer : m_shownLayers)
+				this->updateLayer(*layer);
+
+			// recording draws nothing, so the layer textures are rendered in frames of their own before the frame of the target begins
+			this->updateTextures(target);
+		}
+#endif
 
+		nvgBeginFrame(m_ctx, target.layer().width(), target.layer().height(), pixelRatio);
+
+		if(mapped)
+		{
 #ifdef TOYUI_DRAW_CACHE
-			void* layerCache = nullptr;
-			this->layerCache(target.layer(), layerCache);
-			this->drawLayer(layerCache, 0.f, 0.f, 1.f);
+			// the layers are painted only within the area being redrawn, and those entirely outside of it are skipped
+			const BoxFloat& redraw = target.redrawRect();
+			nvgSave(m_ctx);
+			nvgScissor(m_ctx, redraw.x(), redraw.y(), redraw.w(), redraw.h());
 
-			for(Layer* layer : target.layer().layers())
-				if(layer->visible())
-				{
-					this->layerCache(*layer, layerCache);
-					this->drawLayer(layerCache, 0.f, 0.f, 1.f);
-				}
+			for(Layer* layer : m_shownLayers)
+				if(layer->absoluteRect().intersects(redraw))
+					this->compositeLayer(*layer);
+
+			nvgRestore(m_ctx);
+#else
+			m_drawList.clear();
+			target.layer().widget()->render(*this, false);
+			this->flush(m_drawList);
 #endif
 		}
 
@@ -119,71 +153,43 @@ namespace toy
 		nvgEndFrame(m_ctx);
 	}
 
-	bool NanoRenderer::clipTest(const BoxFloat& rect)
-	{
-		BoxFloat scissor;
-		nvgCurrentScissor(m_ctx, scissor.pointer());
-
-		if(scissor.x1() < 0.f || scissor.y1() < 0.f)
-			return false;
-
-		return !rect.intersects(scissor);
-	}
-
 	void NanoRenderer::clipRect(const BoxFloat& rect)
 	{
-		nvgIntersectScissor(m_ctx, rect.x(), rect.y(), rect.w(), rect.h());
+		m_drawList.clip(rect);
 	}
 
 	void NanoRenderer::unclipRect()
 	{
-		nvgResetScissor(m_ctx);
+		m_drawList.unclip();
 	}
 
 	void NanoRenderer::pathLine(float x1, float y1, float x2, float y2)
 	{
-		nvgBeginPath(m_ctx);
-		nvgMoveTo(m_ctx, x1, y1);
-		nvgLineTo(m_ctx, x2, y2);
+		m_drawList.pathLine(x1, y1, x2, y2);
 	}
 
 	void NanoRenderer::pathBezier(float x1, float y1, float c1x, float c1y, float c2x, float c2y, float x2, float y2)
 	{
-		nvgBeginPath(m_ctx);
-		nvgMoveTo(m_ctx, x1, y1);
-		nvgBezierTo(m_ctx, c1x, c1y, c2x, c2y, x2, y2);
+		m_drawList.pathBezier(x1, y1, c1x, c1y, c2x, c2y, x2, y2);
 	}
 
 	void NanoRenderer::pathRect(const BoxFloat& rect, const BoxFloat& corners, float border)
 	{
 		float halfborder = border * 0.5f;
-
-		// Path
-		if(corners.null())
-			nvgRect(m_ctx, rect.x() + halfborder, rect.y() + halfborder, rect.w() - border, rect.h() - border);
-		else
-			nvgRoundedRectVarying(m_ctx, rect.x() + halfborder, rect.y() + halfborder, rect.w() - border, rect.h() - border, corners.v0(), corners.v1(), corners.v2(), corners.v3());
+		m_drawList.pathRect(BoxFloat(rect.x() + halfborder, rect.y() + halfborder, rect.w() - border, rect.h() - border), corners);
 	}
 
 	void NanoRenderer::drawShadow(const BoxFloat& rect, const BoxFloat& corners, const Shadow& shadow)
 	{
-		NVGpaint shadowPaint = nvgBoxGradient(m_ctx, rect.x() + shadow.d_xpos - shadow.d_spread, rect.y() + shadow.d_ypos - shadow.d_spread, rect.w() + shadow.d_spread * 2.f, rect.h() + shadow.d_spread * 2.f, corners.v0() + shadow.d_spread, shadow.d_blur, nvgRGBA(0, 0, 0, 128), nvgRGBA(0, 0, 0, 0));
-		nvgBeginPath(m_ctx);
-		nvgRect(m_ctx, rect.x() + shadow.d_xpos - shadow.d_radius, rect.y() + shadow.d_ypos - shadow.d_radius, rect.w() + shadow.d_radius * 2.f, rect.h() + shadow.d_radius * 2.f);
-		if(corners.null())
-			nvgRect(m_ctx, rect.x(), rect.y(), rect.w(), rect.h());
-		else
-			nvgRoundedRectVarying(m_ctx, rect.x(), rect.y(), rect.w(), rect.h(), corners.v0(), corners.v1(), corners.v2(), corners.v3());
-		nvgPathWinding(m_ctx, NVG_HOLE);
-		nvgFillPaint(m_ctx, shadowPaint);
-		nvgFill(m_ctx);
+		BoxFloat box(rect.x() + shadow.d_xpos - shadow.d_spread, rect.y() + shadow.d_ypos - shadow.d_spread, rect.w() + shadow.d_spread * 2.f, rect.h() + shadow.d_spread * 2.f);
+		BoxFloat outer(rect.x() + shadow.d_xpos - shadow.d_radius, rect.y() + shadow.d_ypos - shadow.d_radius, rect.w() + shadow.d_radius * 2.f, rect.h() + shadow.d_radius * 2.f);
+		m_drawList.shadow(box, corners.v0() + shadow.d_spread, shadow.d_blur, outer, rect, corners, Colour(0.f, 0.f, 0.f, 128/255.f), Colour(0.f, 0.f, 0.f, 0.f));
 	}
 
 	void NanoRenderer::drawRect(const BoxFloat& rect, const BoxFloat& corners, InkStyle& skin)
 	{
 		float border = skin.borderWidth().x0();
 
-		nvgBeginPath(m_ctx);
 		this->pathRect(rect, corners, border);
 
 		// Fill
@@ -213,36 +219,27 @@ namespace toy
 	{
 		if(skin.linearGradient().null())
 		{
-			nvgFillColor(m_ctx, nvgColour(skin.m_backgroundColour));
+			m_drawList.fill(skin.m_backgroundColour);
 		}
 		else
 		{
-			NVGcolor first = nvgOffsetColour(skin.backgroundColour(), skin.linearGradient().x());
-			NVGcolor second = nvgOffsetColour(skin.backgroundColour(), skin.linearGradient().y());
+			Colour first = offsetColour(skin.backgroundColour(), skin.linearGradient().x());
+			Colour second = offsetColour(skin.backgroundColour(), skin.linearGradient().y());
 			if(skin.linearGradientDim() == DIM_X)
-				nvgFillPaint(m_ctx, nvgLinearGradient(m_ctx, rect.x(), rect.y(), rect.x() + rect.w(), rect.y(), first, second));
+				m_drawList.gradient(rect.x(), rect.y(), rect.x() + rect.w(), rect.y(), first, second);
 			else
-				nvgFillPaint(m_ctx, nvgLinearGradient(m_ctx, rect.x(), rect.y(), rect.x(), rect.y() + rect.h(), first, second));
+				m_drawList.gradient(rect.x(), rect.y(), rect.x(), rect.y() + rect.h(), first, second);
 		}
-		nvgFill(m_ctx);
 	}
 
 	void NanoRenderer::stroke(InkStyle& skin)
 	{
-		float border = skin.borderWidth().x0();
-
-		nvgStrokeWidth(m_ctx, border);
-		nvgStrokeColor(m_ctx, nvgColour(skin.borderColour()));
-		nvgStroke(m_ctx);
+		m_drawList.stroke(skin.borderWidth().x0(), skin.borderColour());
 	}
 
 	void NanoRenderer::drawImage(int image, const BoxFloat& rect, const BoxFloat& imageRect)
 	{
-		NVGpaint imgPaint = nvgImagePattern(m_ctx, imageRect.x(), imageRect.y(), imageRect.w(), imageRect.h(), 0.0f / 180.0f*NVG_PI, image, 1.f);
-		nvgBeginPath(m_ctx);
-		nvgRect(m_ctx, rect.x(), rect.y(), rect.w(), rect.h());
-		nvgFillPaint(m_ctx, imgPaint);
-		nvgFill(m_ctx);
+		m_drawList.image(image, rect, imageRect);
 	}
 
 	void NanoRenderer::drawImage(const Image& image, const BoxFloat& rect)
@@ -391,8 +388,112 @@ namespace toy
 	{
 		this->setupText(skin);
 
-		nvgFillColor(m_ctx, nvgColour(skin.m_textColour));
-		nvgText(m_ctx, x, y, start, end);
+		float bounds[4];
+		nvgTextBounds(m_ctx, x, y, start, end, bounds);
+		m_drawList.text(x, y, start, end, skin.textFont(), skin.textSize(), skin.align()[DIM_X], skin.m_textColour, BoxFloat(bounds[0], bounds[1], bounds[2] - bounds[0], bounds[3] - bounds[1]));
+	}
+
+	void NanoRenderer::pathCommand(const DrawCommand& command)
+	{
+		const float* path = command.path;
+		if(command.shape == DrawCommand::RECT)
+			nvgRect(m_ctx, path[0], path[1], path[2], path[3]);
+		else if(command.shape == DrawCommand::ROUNDED_RECT)
+			nvgRoundedRectVarying(m_ctx, path[0], path[1], path[2], path[3], path[4], path[5], path[6], path[7]);
+		else if(command.shape == DrawCommand::LINE)
+		{
+			nvgMoveTo(m_ctx, path[0], path[1]);
+			nvgLineTo(m_ctx, path[2], path[3]);
+		}
+		else
+		{
+			nvgMoveTo(m_ctx, path[0], path[1]);
+			nvgBezierTo(m_ctx, path[2], path[3], path[4], path[5], path[6], path[7]);
+		}
+	}
+
+	void NanoRenderer::submitCommand(DrawList& list, const DrawCommand& command)
+	{
+		const float* paint = command.paint;
+		if(command.kind == DrawCommand::TEXT)
+		{
+			int alignH = command.align == CENTER ? NVG_ALIGN_CENTER : command.align == RIGHT ? NVG_ALIGN_RIGHT : NVG_ALIGN_LEFT;
+			nvgFontSize(m_ctx, paint[2]);
+			nvgFontFace(m_ctx, list.font(command).c_str());
+			nvgTextAlign(m_ctx, alignH | NVG_ALIGN_TOP);
+			nvgFillColor(m_ctx, nvgColour(command.colour));
+			nvgText(m_ctx, paint[0], paint[1], list.text(command), list.text(command) + command.length);
+			return;
+		}
+
+		nvgBeginPath(m_ctx);
+		if(command.kind == DrawCommand::GRADIENT)
+		{
+			this->pathCommand(command);
+			nvgFillPaint(m_ctx, nvgLinearGradient(m_ctx, paint[0], paint[1], paint[2], paint[3], nvgColour(command.colour), nvgColour(command.colour2)));
+		}
+		else if(command.kind == DrawCommand::SHADOW)
+		{
+			nvgRect(m_ctx, command.outer[0], command.outer[1], command.outer[2], command.outer[3]);
+			this->pathCommand(command);
+			nvgPathWinding(m_ctx, NVG_HOLE);
+			nvgFillPaint(m_ctx, nvgBoxGradient(m_ctx, paint[0], paint[1], paint[2], paint[3], paint[4], paint[5], nvgColour(command.colour), nvgColour(command.colour2)));
+		}
+		else if(command.kind == DrawCommand::IMAGE)
+		{
+			this->pathCommand(command);
+			nvgFillPaint(m_ctx, nvgImagePattern(m_ctx, paint[0], paint[1], paint[2], paint[3], 0.f, command.texture, 1.f));
+		}
+		nvgFill(m_ctx);
+	}
+
+	void NanoRenderer::submit(DrawList& list)
+	{
+		// clips are intersected with the scissor the list is submitted within
+		nvgSave(m_ctx);
+
+		uint32_t clip = 0;
+		for(const DrawList::Run& run : list.runs())
+		{
+			if(run.clip != clip)
+			{
+				clip = run.clip;
+				nvgRestore(m_ctx);
+				nvgSave(m_ctx);
+				if(clip)
+				{
+					const BoxFloat& rect = list.clipRect(run.clip);
+					nvgIntersectScissor(m_ctx, rect.x(), rect.y(), rect.w(), rect.h());
+				}
+			}
+
+			// the fills and strokes of a run share their paint, their paths are submitted as a single one
+			const DrawCommand& first = list.command(run.begin);
+			if(first.kind == DrawCommand::FILL || first.kind == DrawCommand::STROKE)
+			{
+				nvgBeginPath(m_ctx);
+				for(size_t i = run.begin; i < run.end; ++i)
+					this->pathCommand(list.command(i));
+
+				if(first.kind == DrawCommand::FILL)
+				{
+					nvgFillColor(m_ctx, nvgColour(first.colour));
+					nvgFill(m_ctx);
+				}
+				else
+				{
+					nvgStrokeWidth(m_ctx, first.paint[0]);
+					nvgStrokeColor(m_ctx, nvgColour(first.colour));
+					nvgStroke(m_ctx);
+				}
+				continue;
+			}
+
+			for(size_t i = run.begin; i < run.end; ++i)
+				this->submitCommand(list, list.command(i));
+		}
+
+		nvgRestore(m_ctx);
 	}
 
 	void NanoRenderer::beginTarget()
@@ -402,44 +503,290 @@ namespace toy
 		nvgSave(m_ctx);
 		nvgResetTransform(m_ctx);
 		nvgResetScissor(m_ctx);
+#ifndef TOYUI_DRAW_CACHE
+		m_drawList.resetState();
+#endif
 	}
 
 	void NanoRenderer::endTarget()
 	{
 		m_debugDepth--;
 
+#ifndef TOYUI_DRAW_CACHE
+		m_drawList.popState();
+#endif
 		nvgRestore(m_ctx);
 	}
 
 #ifdef TOYUI_DRAW_CACHE
 	void NanoRenderer::layerCache(Layer& layer, void*& cache)
 	{
-		if(m_layers.find(&layer) == m_layers.end())
-			m_layers[&layer] = nvgCreateDisplayList(-1);
+		LayerSegments& segments = m_layers[&layer];
+		segments.layer = &layer;
+		cache = &segments;
+	}
 
-		cache = m_layers[&layer];
+	static BoxFloat intersectRects(const BoxFloat& first, const BoxFloat& second)
+	{
+		float x0 = std::max(first.x(), second.x());
+		float y0 = std::max(first.y(), second.y());
+		float x1 = std::min(first.x() + first.w(), second.x() + second.w());
+		float y1 = std::min(first.y() + first.h(), second.y() + second.h());
+		return BoxFloat(x0, y0, std::max(0.f, x1 - x0), std::max(0.f, y1 - y0));
+	}
+
+	BoxFloat NanoRenderer::inheritedClip(Layer& layer)
+	{
+		// a layer is still clipped by the frames it is nested in, which are drawn by its parent layers
+		BoxFloat clip;
+		for(Frame* frame = layer.parent(); frame; frame = frame->parent())
+			if(frame->widget() && frame->clip() && !frame->hidden())
+			{
+				BoxFloat rect = frame->absoluteRect();
+				clip = clip.null() ? rect : intersectRects(clip, rect);
+			}
+		return clip;
 	}
 
 	void NanoRenderer::drawLayer(void* layerCache, float x, float y, float scale)
 	{
+		LayerSegments& layer = *(LayerSegments*)layerCache;
+
+		m_clips.clear();
+		if(layer.layer)
+		{
+			BoxFloat inherited = this->inheritedClip(*layer.layer);
+			if(!inherited.null())
+				m_clips.push_back({ 0, inherited });
+		}
+
+		m_layerList.clear();
+
+		size_t index = 0;
+		while(index < layer.segments.size())
+		{
+			SegmentEntry& entry = layer.segments[index++];
+			if(entry.segment->released)
+				continue;
+
+			// the clip of a frame applies until a frame that isn't nested in it is appended
+			while(!m_clips.empty() && m_clips.back().depth >= entry.depth)
+				m_clips.pop_back();
+
+			++m_visitedFrames;
+
+			DimFloat position = entry.frame->absolutePosition();
+			float left = std::floor(position.x());
+			float top = std::floor(position.y());
+			float factor = entry.frame->absoluteScale();
+
+			BoxFloat rect(left, top, entry.frame->width() * factor, entry.frame->height() * factor);
+			BoxFloat clip = m_clips.empty() ? BoxFloat() : m_clips.back().rect;
+
+			// the subtree of a clipping frame that falls outside of the clip is skipped as a whole
+			bool visible = clip.null() || rect.intersects(clip);
+			if(!visible && !entry.clip.null())
+			{
+				index = std::max(index, entry.end);
+				continue;
+			}
+
+			if(visible)
+			{
+				++m_drawnFrames;
+				m_layerList.append(entry.segment->commands, left, top, factor, clip);
+			}
+
+			if(!entry.clip.null())
+			{
+				BoxFloat own(left + entry.clip.x() * factor, top + entry.clip.y() * factor, entry.clip.w() * factor, entry.clip.h() * factor);
+				m_clips.push_back({ entry.depth, clip.null() ? own : intersectRects(clip, own) });
+			}
+		}
+
+		// the commands of the whole layer are sorted at once, so that batches merge across its frames
 		nvgSave(m_ctx);
 		nvgTranslate(m_ctx, x, y);
 		nvgScale(m_ctx, scale, scale);
-		nvgDrawDisplayList(m_ctx, (NVGdisplayList*)layerCache);
+		this->flush(m_layerList);
 		nvgRestore(m_ctx);
 	}
 
+	void NanoRenderer::occludeLayers(RenderTarget& target)
+	{
+		const BoxFloat& redraw = target.redrawRect();
+		m_shownLayers.clear();
+		m_covers.clear();
+
+		auto occlude = [&](Layer& layer) {
+			if(!layer.visible())
+				return;
+
+			// a layer is hidden when the part of it being redrawn lies within the opaque area of a single layer above it
+			BoxFloat rect = intersectRects(layer.absoluteRect(), redraw);
+			auto covers = [&rect](const BoxFloat& cover) {
+				return rect.x() >= cover.x() && rect.y() >= cover.y() && rect.x() + rect.w() <= cover.x() + cover.w() && rect.y() + rect.h() <= cover.y() + cover.h();
+			};
+
+			if(rect.w() > 0.f && rect.h() > 0.f && std::any_of(m_covers.begin(), m_covers.end(), covers))
+			{
+				++m_occludedLayers;
+				return;
+			}
+
+			m_shownLayers.push_back(&layer);
+
+			BoxFloat opaque = layer.content().opaqueRect();
+			BoxFloat inherited = this->inheritedClip(layer);
+			if(!opaque.null() && !inherited.null())
+				opaque = intersectRects(opaque, inherited);
+			if(!opaque.null() && opaque.w() > 0.f && opaque.h() > 0.f)
+				m_covers.push_back(opaque);
+		};
+
+		// coverage is gathered from the top layer down, the master layer being the bottom one
+		const std::vector<Layer*>& layers = target.layer().layers();
+		for(auto it = layers.rbegin(); it != layers.rend(); ++it)
+			occlude(**it);
+		occlude(target.layer());
+
+		std::reverse(m_shownLayers.begin(), m_shownLayers.end());
+	}
+
+	void NanoRenderer::updateLayer(Layer& layer)
+	{
+		// a layer whose frames only moved replays the segments it has at their new place
+		if(layer.redraw())
+		{
+			this->resetCulls();
+			layer.widget()->render(*this, false);
+		}
+		else if(layer.replay())
+		{
+			m_layers[&layer].textured = false;
+			layer.endRedraw();
+		}
+	}
+
+	void NanoRenderer::updateTextures(RenderTarget& target)
+	{
+		for(Layer* layer : m_shownLayers)
+		{
+			if(layer == &target.layer() || !layer->cacheable() || m_layers[layer].textured)
+				continue;
+
+			LayerSegments& segments = m_layers[layer];
+
+			// the texture spans every pixel the layer touches, from the pixel its origin falls in, where it is composited
+			BoxFloat rect = layer->absoluteRect();
+			float left = std::floor(rect.x());
+			float top = std::floor(rect.y());
+			int width = int(std::ceil(rect.x() + rect.w()) - left);
+			int height = int(std::ceil(rect.y() + rect.h()) - top);
+
+			if(width <= 0 || height <= 0 || !this->beginLayerTexture(segments, width, height))
+				continue;
+
+			nvgBeginFrame(m_ctx, width, height, 1.f);
+			this->drawLayer(&segments, -left, -top, 1.f);
+			nvgEndFrame(m_ctx);
+
+			this->endLayerTexture(target);
+			segments.textured = true;
+			++m_layerTextures;
+		}
+	}
+
+	void NanoRenderer::compositeLayer(Layer& layer)
+	{
+		void* cache = nullptr;
+		this->layerCache(layer, cache);
+		LayerSegments& segments = *(LayerSegments*)cache;
+
+		if(!layer.cacheable() || !segments.textured)
+		{
+			this->drawLayer(cache, 0.f, 0.f, 1.f);
+			return;
+		}
+
+		BoxFloat rect = layer.absoluteRect();
+		float x = std::floor(rect.x());
+		float y = std::floor(rect.y());
+
+		NVGpaint paint = nvgImagePattern(m_ctx, x, y, float(segments.width), float(segments.height), 0.f, segments.image, 1.f);
+		nvgBeginPath(m_ctx);
+		nvgRect(m_ctx, x, y, float(segments.width), float(segments.height));
+		nvgFillPaint(m_ctx, paint);
+		nvgFill(m_ctx);
+	}
+
 	void NanoRenderer::clearLayer(void* layerCache)
 	{
-		nvgResetDisplayList((NVGdisplayList*)layerCache);
+		LayerSegments& layer = *(LayerSegments*)layerCache;
+		for(SegmentEntry& entry : layer.segments)
+			this->unrefSegment(*entry.segment);
+		layer.segments.clear();
+		layer.textured = false;
 		//nvgResetScissor(m_ctx);
 	}
 
+	void NanoRenderer::segmentCache(void*& segment)
+	{
+		if(!segment)
+			segment = new Segment{ DrawList(), 0, false };
+	}
+
+	void NanoRenderer::releaseSegment(void* segment)
+	{
+		Segment* released = (Segment*)segment;
+		released->released = true;
+		if(released->refs == 0)
+			delete released;
+	}
+
+	void NanoRenderer::unrefSegment(Segment& segment)
+	{
+		if(--segment.refs == 0 && segment.released)
+			delete &segment;
+	}
+
+	void NanoRenderer::recordSegment(void* segment)
+	{
+		Segment& recorded = *(Segment*)segment;
+
+		// commands are recorded relative to the frame, and unclipped by the frames around it
+		m_drawList.clear();
+		m_recording = &recorded;
+		++m_recordedSegments;
+	}
+
+	void NanoRenderer::endSegment()
+	{
+		if(!m_recording)
+			return;
+
+		// the segment keeps the commands, the list recorded into takes over the buffers of its previous ones
+		std::swap(m_recording->commands, m_drawList);
+	}
+
+	void NanoRenderer::appendSegment(Frame& frame, void* segment, const BoxFloat& clip)
+	{
+		Segment& appended = *(Segment*)segment;
+		LayerSegments& layer = *m_updates.back();
+		m_open.push_back({ &layer, layer.segments.size() });
+		layer.segments.push_back({ &appended, &frame, m_updates.size(), layer.segments.size() + 1, clip });
+		++appended.refs;
+
+		if(m_recording != &appended)
+			++m_reusedSegments;
+		m_recording = nullptr;
+	}
+
 	void NanoRenderer::beginUpdate(void* layerCache, float x, float y, float scale)
 	{
 		m_debugDepth++;
 
-		nvgBindDisplayList(m_ctx, (NVGdisplayList*)layerCache);
+		m_updates.push_back((LayerSegments*)layerCache);
 		nvgSave(m_ctx);
 		nvgTranslate(m_ctx, x, y);
 		nvgScale(m_ctx, scale, scale);
@@ -451,20 +798,30 @@ namespace toy
 	{
 		m_debugDepth--;
 
+		// the subtree of the segment appended at this depth ends here
+		if(!m_open.empty())
+		{
+			SegmentEntry& entry = m_open.back().first->segments[m_open.back().second];
+			if(entry.depth == m_updates.size())
+			{
+				entry.end = m_open.back().first->segments.size();
+				m_open.pop_back();
+			}
+		}
+
 		nvgRestore(m_ctx);
-		nvgBindDisplayList(m_ctx, nullptr);
+		m_updates.pop_back();
 	}
 
 #else
 	void NanoRenderer::beginUpdate(float x, float y)
 	{
-		nvgSave(m_ctx);
-		nvgTranslate(m_ctx, x, y);
+		m_drawList.pushState(x, y);
 	}
 
 	void NanoRenderer::endUpdate()
 	{
-		nvgRestore(m_ctx);
+		m_drawList.popState();
 	}
 #endif
 
@@ -8,6 +8,7 @@
 /* toy */
 #include <toyui/Forward.h>
 #include <toyui/Render/Renderer.h>
+#include <toyui/Render/DrawList.h>
 
 namespace toy
 {
@@ -38,6 +39,12 @@ namespace toy
 		virtual void clearLayer(void* layerCache);
 		virtual void drawLayer(void* layerCache, float x, float y, float scale);
 
+		virtual void segmentCache(void*& segment);
+		virtual void releaseSegment(void* segment);
+		virtual void recordSegment(void* segment);
+		virtual void endSegment();
+		virtual void appendSegment(Frame& frame, void* segment, const BoxFloat& clip);
+
 		virtual void beginUpdate(void* layerCache, float x, float y, float scale);
 		virtual void endUpdate();
 #else
@@ -45,7 +52,6 @@ namespace toy
 		virtual void endUpdate();
 #endif
 
-		virtual bool clipTest(const BoxFloat& rect);
 		virtual void clipRect(const BoxFloat& rect);
 		virtual void unclipRect();
 
@@ -77,17 +83,84 @@ namespace toy
 		virtual float textLineHeight(InkStyle& skin);
 		virtual float textSize(const string& text, Dimension dim, InkStyle& skin);
 
+		virtual void submit(DrawList& list);
+
 	private:
 		void setupText(InkStyle& skin);
 
 		void drawImage(int image, const BoxFloat& rect, const BoxFloat& imageRect);
 
+		void pathCommand(const DrawCommand& command);
+		void submitCommand(DrawList& list, const DrawCommand& command);
+
 	protected:
 		NVGcontext* m_ctx;
 
 		float m_lineHeight;
 
-		std::map<Layer*, NVGdisplayList*> m_layers;
+		DrawList m_drawList;
+
+#ifdef TOYUI_DRAW_CACHE
+		// a segment is freed once its frame is gone and no layer replays it anymore
+		struct Segment
+		{
+			DrawList commands;
+			size_t refs;
+			bool released;
+		};
+
+		// where the segment is replayed is only known from its frame when the layer is drawn
+		struct SegmentEntry
+		{
+			Segment* segment;
+			Frame* frame;
+			size_t depth;
+			size_t end;
+			BoxFloat clip;
+		};
+
+		struct LayerSegments
+		{
+			Layer* layer = nullptr;
+			std::vector<SegmentEntry> segments;
+
+			// the texture the layer is composited from, valid until the segments are cleared
+			void* framebuffer = nullptr;
+			int image = 0;
+			int width = 0;
+			int height = 0;
+			bool textured = false;
+		};
+
+		struct ClipEntry
+		{
+			size_t depth;
+			BoxFloat rect;
+		};
+
+		void unrefSegment(Segment& segment);
+		BoxFloat inheritedClip(Layer& layer);
+
+		void occludeLayers(RenderTarget& target);
+		void updateLayer(Layer& layer);
+		void updateTextures(RenderTarget& target);
+		void compositeLayer(Layer& layer);
+
+		// offscreen textures layers are rendered to, when the backend provides them
+		virtual bool beginLayerTexture(LayerSegments& layer, int width, int height) { UNUSED(layer); UNUSED(width); UNUSED(height); return false; }
+		virtual void endLayerTexture(RenderTarget& target) { UNUSED(target); }
+
+		std::map<Layer*, LayerSegments> m_layers;
+		std::vector<LayerSegments*> m_updates;
+		std::vector<Layer*> m_shownLayers;
+		std::vector<BoxFloat> m_covers;
+		std::vector<ClipEntry> m_clips;
+		std::vector<std::pair<LayerSegments*, size_t>> m_open;
+		Segment* m_recording;
+
+		// the commands of all the segments a layer replays, sorted and submitted together
+		DrawList m_layerList;
+#endif
 	};
 }
 
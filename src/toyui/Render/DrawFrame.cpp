@@ -12,10 +12,15 @@
 #include <toyui/UiWindow.h>
 #include <toyui/Widget/RootSheet.h>
 
+#include <mutex>
+
 namespace toy
 {
 	Renderer* DrawFrame::sRenderer = nullptr;
 
+	// text metrics go through the renderer, which isn't safe to share between layout threads
+	static std::mutex s_textMutex;
+
 	string DrawFrame::sDebugPrintFilter = "";
 	bool DrawFrame::sDebugPrint = true;
 	string DrawFrame::sDebugDrawFilter = "";
@@ -32,8 +37,24 @@ namespace toy
 		, m_textLines(0)
 		, m_image(nullptr)
 		, d_inkstyle(nullptr)
+		, d_breakSpace(0.f, 0.f)
+		, d_breakStamp(0)
+		, d_segment(nullptr)
+		, d_recorded(false)
+		, d_customDrawn(false)
+		, d_culling(false)
+		, d_culledContents(false)
+		, d_culled(false)
 	{}
 
+	DrawFrame::~DrawFrame()
+	{
+#ifdef TOYUI_DRAW_CACHE
+		if(d_segment && sRenderer)
+			sRenderer->releaseSegment(d_segment);
+#endif
+	}
+
 	bool DrawFrame::empty()
 	{
 		return m_text.empty() && m_image == nullptr && d_inkstyle->image() == nullptr;
@@ -70,8 +91,8 @@ namespace toy
 		if(!d_inkstyle)
 			return;
 
+		d_frame->markDirty(Frame::DIRTY_CONTENT);
 		this->updateTextLineBreaks();
-		d_frame->setDirty(Frame::DIRTY_CONTENT);
 	}
 
 	void DrawFrame::updateTextLineBreaks()
@@ -81,6 +102,13 @@ namespace toy
 
 		DimFloat paddedSize(paddedWidth, paddedHeight);
 
+		if(paddedSize[DIM_X] == d_breakSpace[DIM_X] && paddedSize[DIM_Y] == d_breakSpace[DIM_Y] && d_breakStamp == d_frame->contentStamp())
+			return;
+
+		d_breakSpace = paddedSize;
+		d_breakStamp = d_frame->contentStamp();
+
+		std::lock_guard<std::mutex> lock(s_textMutex);
 		d_caption.updateTextRows(*sRenderer, paddedSize);
 	}
 
@@ -99,7 +127,10 @@ namespace toy
 		else if(m_image)
 			return dim == DIM_X ? float(m_image->d_width) : float(m_image->d_height);
 		else if(m_textLines && dim == DIM_Y)
+		{
+			std::lock_guard<std::mutex> lock(s_textMutex);
 			return sRenderer->textLineHeight(*d_inkstyle) * m_textLines;
+		}
 		else if(d_inkstyle->image())
 			return dim == DIM_X ? float(d_inkstyle->image()->d_width) : float(d_inkstyle->image()->d_height);
 		else if(!d_inkstyle->imageSkin().null())
@@ -145,30 +176,88 @@ namespace toy
 #endif
 	}
 
+	BoxFloat DrawFrame::marginRect()
+	{
+		float left = floor(d_inkstyle->margin().x0());
+		float top = floor(d_inkstyle->margin().y0());
+		float width = floor(d_frame->width() - d_inkstyle->margin().x0() - d_inkstyle->margin().x1());
+		float height = floor(d_frame->height() - d_inkstyle->margin().y0() - d_inkstyle->margin().y1());
+
+		return BoxFloat(left, top, width, height);
+	}
+
+	BoxFloat DrawFrame::opaqueRect()
+	{
+		// only a plain background is known to cover everything within the border
+		if(!d_inkstyle || d_customDrawn || d_inkstyle->customRenderer() != nullptr || d_inkstyle->empty() || !d_frame->hardClip().null())
+			return BoxFloat();
+
+		if(d_inkstyle->backgroundColour().a() < 1.f || !d_inkstyle->cornerRadius().cnull())
+			return BoxFloat();
+
+		BoxFloat margin = this->marginRect();
+		float border = d_inkstyle->borderWidth().x0();
+		DimFloat origin = d_frame->absolutePosition();
+		float scale = d_frame->absoluteScale();
+
+		float width = (margin.w() - border * 2.f) * scale;
+		float height = (margin.h() - border * 2.f) * scale;
+		if(width <= 0.f || height <= 0.f)
+			return BoxFloat();
+
+		return BoxFloat(origin.x() + (margin.x() + border) * scale, origin.y() + (margin.y() + border) * scale, width, height);
+	}
+
 	void DrawFrame::draw(Renderer& renderer, bool force)
 	{
 #ifdef TOYUI_DRAW_CACHE
 		if(!(d_frame->layer().redraw() || force))
 			return;
+
+		// an unchanged frame replays its segment : it is recorded in the space of the frame, so moving the frame or its parents keeps it valid
+		renderer.segmentCache(d_segment);
+		if(force || !d_recorded)
+		{
+			renderer.recordSegment(d_segment);
+			this->paint(renderer);
+			renderer.endSegment();
+			d_recorded = true;
+		}
+
+		bool clips = d_frame->clip() && !d_customDrawn;
+		renderer.appendSegment(*d_frame, d_segment, clips ? this->marginRect() : BoxFloat());
+#else
+		this->paint(renderer);
+		bool clips = d_frame->clip() && !d_customDrawn;
 #endif
-		bool custom = d_frame->widget()->customDraw(renderer);
-		if(custom)
+		renderer.countDraw();
+
+		// the contents are culled against the clip of the frame
+		d_culling = clips;
+		if(clips)
+		{
+			BoxFloat margin = this->marginRect();
+			DimFloat origin = d_frame->absolutePosition();
+			float scale = d_frame->absoluteScale();
+			renderer.pushCull(BoxFloat(origin.x() + margin.x() * scale, origin.y() + margin.y() * scale, margin.w() * scale, margin.h() * scale));
+		}
+	}
+
+	void DrawFrame::paint(Renderer& renderer)
+	{
+		d_customDrawn = d_frame->widget()->customDraw(renderer);
+		if(d_customDrawn)
 			return;
 
 		if(d_inkstyle->customRenderer() != nullptr)
 		{
 			CustomRenderer func = d_inkstyle->customRenderer();
-			custom = func(*d_frame, renderer);
-			if(custom)
+			d_customDrawn = func(*d_frame, renderer);
+			if(d_customDrawn)
 				return;
 		}
 
-		float left = floor(d_inkstyle->margin().x0());
-		float top = floor(d_inkstyle->margin().y0());
-		float width = floor(d_frame->width() - d_inkstyle->margin().x0() - d_inkstyle->margin().x1());
-		float height = floor(d_frame->height() - d_inkstyle->margin().y0() - d_inkstyle->margin().y1());
-
-		BoxFloat rect(left, top, width, height);
+		BoxFloat rect = this->marginRect();
 
 #if 1 // DEBUG
 		if(d_frame->style().name() == sDebugDrawFilter)
@@ -178,9 +267,6 @@ namespace toy
 		if(d_frame->clip())
 			renderer.clipRect(rect);
 
-		if(renderer.clipTest(rect))
-			return;
-
 		if(d_inkstyle->m_empty)
 			return;
 
@@ -220,6 +306,10 @@ namespace toy
 
 	void DrawFrame::endDraw(Renderer& renderer)
 	{
+		if(d_culling)
+			renderer.popCull();
+		d_culling = false;
+
 		renderer.endUpdate();
 
 		if(d_frame->frameType() >= LAYER)
@@ -237,7 +327,15 @@ namespace toy
 
 	void DrawFrame::updateInkstyle(InkStyle& inkstyle)
 	{
-		if(d_inkstyle != &inkstyle)
+		if(d_inkstyle == &inkstyle)
+			return;
+
+		if(d_inkstyle && d_inkstyle->sameMetrics(inkstyle))
+		{
+			d_inkstyle = &inkstyle;
+			d_frame->markDirty(Frame::DIRTY_PAINT);
+		}
+		else
 			this->resetInkstyle(inkstyle);
 	}
 }
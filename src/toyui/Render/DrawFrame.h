@@ -18,9 +18,11 @@ namespace toy
 	{
 	public:
 		DrawFrame(Frame& frame);
+		~DrawFrame();
 
-		DrawFrame(const DrawFrame&) = default;
-		DrawFrame& operator=(const DrawFrame&) = default;
+		// the recorded segment belongs to a single frame
+		DrawFrame(const DrawFrame&) = delete;
+		DrawFrame& operator=(const DrawFrame&) = delete;
 
 		inline Frame& frame() { return *d_frame; }
 		inline Stencil& stencil() { return d_stencil; }
@@ -43,6 +45,17 @@ namespace toy
 		void draw(Renderer& renderer, bool force);
 		void endDraw(Renderer& renderer);
 
+		// the commands recorded for the frame are replayed until it changes
+		void invalidate() { d_recorded = false; }
+
+		// whether the last traversal skipped some of the contents of the frame, or anything in its subtree
+		bool culledContents() { return d_culledContents; }
+		bool culled() { return d_culled; }
+		void setCulled(bool contents, bool subtree) { d_culledContents = contents; d_culled = contents || subtree; }
+
+		// absolute area the frame paints entirely opaque, null when nothing beneath it is known to be covered
+		BoxFloat opaqueRect();
+
 		void updateInkstyle(InkStyle& inkstyle);
 		void resetInkstyle(InkStyle& inkstyle);
 
@@ -54,6 +67,10 @@ namespace toy
 		float contentSize(Dimension dim);
 		void contentPos(const BoxFloat& paddedRect, const DimFloat& size, Dimension dim, DimFloat& pos);
 
+	protected:
+		BoxFloat marginRect();
+		void paint(Renderer& renderer);
+
 	protected:
 		Frame* d_frame;
 
@@ -67,6 +84,18 @@ namespace toy
 
 		InkStyle* d_inkstyle;
 
+		// space and content the text was last broken for
+		DimFloat d_breakSpace;
+		size_t d_breakStamp;
+
+		void* d_segment;
+		bool d_recorded;
+		bool d_customDrawn;
+
+		bool d_culling;
+		bool d_culledContents;
+		bool d_culled;
+
 	public:
 		static Renderer* sRenderer;
 
@@ -0,0 +1,482 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Render/DrawList.h>
+
+#include <toyobj/Util/Colour.h>
+
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <cassert>
+
+namespace toy
+{
+	size_t DrawList::s_lookback = 64;
+
+	uint32_t DrawCommand::state() const
+	{
+		// solid paint, gradients, and each texture are a state of their own, text being drawn from the font atlas
+		switch(kind)
+		{
+		case FILL:
+		case STROKE:
+			return 0;
+		case GRADIENT:
+		case SHADOW:
+			return 1;
+		case TEXT:
+			return 2;
+		case IMAGE:
+		default:
+			return 3 + uint32_t(texture);
+		}
+	}
+
+	static void assignColour(float* out, const Colour& colour)
+	{
+		out[0] = colour.r();
+		out[1] = colour.g();
+		out[2] = colour.b();
+		out[3] = colour.a();
+	}
+
+	static bool overlaps(const float* first, const float* second)
+	{
+		return first[0] < second[2] && second[0] < first[2] && first[1] < second[3] && second[1] < first[3];
+	}
+
+	static void extend(float* bounds, const float* other)
+	{
+		bounds[0] = std::min(bounds[0], other[0]);
+		bounds[1] = std::min(bounds[1], other[1]);
+		bounds[2] = std::max(bounds[2], other[2]);
+		bounds[3] = std::max(bounds[3], other[3]);
+	}
+
+	static size_t hashClip(const BoxFloat& clip)
+	{
+		float values[4] = { clip.x(), clip.y(), clip.w(), clip.h() };
+		uint32_t bits[4];
+		memcpy(bits, values, sizeof(bits));
+
+		size_t hash = 0;
+		for(uint32_t word : bits)
+			hash = hash * 31 + std::hash<uint32_t>()(word);
+		return hash;
+	}
+
+	static bool sameClip(const BoxFloat& first, const BoxFloat& second)
+	{
+		return first.x() == second.x() && first.y() == second.y() && first.w() == second.w() && first.h() == second.h();
+	}
+
+	static bool merges(const DrawCommand& first, const DrawCommand& second)
+	{
+		if(first.kind != second.kind || (first.kind != DrawCommand::FILL && first.kind != DrawCommand::STROKE))
+			return false;
+		if(first.kind == DrawCommand::STROKE && first.paint[0] != second.paint[0])
+			return false;
+		return memcmp(first.colour, second.colour, sizeof(first.colour)) == 0;
+	}
+
+	DrawList::DrawList()
+	{
+		this->clear();
+	}
+
+	void DrawList::clear()
+	{
+		d_commands.clear();
+		d_text.clear();
+		d_order.clear();
+		d_runs.clear();
+
+		// the first clip stands for no clipping
+		d_clips.clear();
+		d_clips.emplace_back();
+		d_clipLookup.clear();
+
+		d_states.clear();
+		d_states.push_back({ 0.f, 0.f, 0 });
+	}
+
+	void DrawList::pushState(float x, float y)
+	{
+		State state = d_states.back();
+		state.x += x;
+		state.y += y;
+		d_states.push_back(state);
+	}
+
+	void DrawList::resetState()
+	{
+		d_states.push_back({ 0.f, 0.f, 0 });
+	}
+
+	void DrawList::popState()
+	{
+		d_states.pop_back();
+	}
+
+	void DrawList::clip(const BoxFloat& rect)
+	{
+		State& state = d_states.back();
+		float x0 = rect.x() + state.x;
+		float y0 = rect.y() + state.y;
+		float x1 = x0 + rect.w();
+		float y1 = y0 + rect.h();
+
+		if(state.clip)
+		{
+			const BoxFloat& current = d_clips[state.clip];
+			x0 = std::max(x0, current.x());
+			y0 = std::max(y0, current.y());
+			x1 = std::min(x1, current.x() + current.w());
+			y1 = std::min(y1, current.y() + current.h());
+		}
+
+		state.clip = this->addClip(BoxFloat(x0, y0, std::max(0.f, x1 - x0), std::max(0.f, y1 - y0)));
+	}
+
+	uint32_t DrawList::addClip(const BoxFloat& clip)
+	{
+		// frames clipped to the same area share a clip, so that their commands can be batched together
+		size_t hash = hashClip(clip);
+		auto it = d_clipLookup.find(hash);
+		if(it != d_clipLookup.end() && sameClip(d_clips[it->second], clip))
+			return it->second;
+
+		// a colliding clip only takes over the lookup, which costs a duplicate at worst
+		assert(d_clips.size() < UINT32_MAX);
+		uint32_t index = uint32_t(d_clips.size());
+		d_clips.push_back(clip);
+		d_clipLookup[hash] = index;
+		return index;
+	}
+
+	void DrawList::unclip()
+	{
+		d_states.back().clip = 0;
+	}
+
+	void DrawList::pathRect(const BoxFloat& rect, const BoxFloat& corners)
+	{
+		State& state = d_states.back();
+		bool rounded = !corners.null();
+		d_path.shape = rounded ? DrawCommand::ROUNDED_RECT : DrawCommand::RECT;
+
+		float path[8] = { rect.x() + state.x, rect.y() + state.y, rect.w(), rect.h(), corners.v0(), corners.v1(), corners.v2(), corners.v3() };
+		memcpy(d_path.path, path, sizeof(path));
+
+		float bounds[4] = { path[0], path[1], path[0] + path[2], path[1] + path[3] };
+		memcpy(d_path.bounds, bounds, sizeof(bounds));
+	}
+
+	void DrawList::pathLine(float x1, float y1, float x2, float y2)
+	{
+		this->pathBezier(x1, y1, x1, y1, x2, y2, x2, y2);
+		d_path.shape = DrawCommand::LINE;
+		d_path.path[2] = d_path.path[6];
+		d_path.path[3] = d_path.path[7];
+	}
+
+	void DrawList::pathBezier(float x1, float y1, float c1x, float c1y, float c2x, float c2y, float x2, float y2)
+	{
+		State& state = d_states.back();
+		d_path.shape = DrawCommand::BEZIER;
+
+		float path[8] = { x1 + state.x, y1 + state.y, c1x + state.x, c1y + state.y, c2x + state.x, c2y + state.y, x2 + state.x, y2 + state.y };
+		memcpy(d_path.path, path, sizeof(path));
+
+		// the curve lies within the hull of its control points
+		d_path.bounds[0] = std::min({ path[0], path[2], path[4], path[6] });
+		d_path.bounds[1] = std::min({ path[1], path[3], path[5], path[7] });
+		d_path.bounds[2] = std::max({ path[0], path[2], path[4], path[6] });
+		d_path.bounds[3] = std::max({ path[1], path[3], path[5], path[7] });
+	}
+
+	DrawCommand& DrawList::emit(DrawCommand::Kind kind, const Colour& colour, float margin)
+	{
+		d_commands.push_back(d_path);
+		DrawCommand& command = d_commands.back();
+		command.kind = kind;
+		command.clip = d_states.back().clip;
+		command.texture = 0;
+		command.align = 0;
+		command.text = 0;
+		command.length = 0;
+		assignColour(command.colour, colour);
+
+		// antialiasing spreads each primitive by a pixel
+		margin += 1.f;
+		command.bounds[0] -= margin;
+		command.bounds[1] -= margin;
+		command.bounds[2] += margin;
+		command.bounds[3] += margin;
+
+		if(command.clip)
+		{
+			const BoxFloat& clip = d_clips[command.clip];
+			command.bounds[0] = std::max(command.bounds[0], clip.x());
+			command.bounds[1] = std::max(command.bounds[1], clip.y());
+			command.bounds[2] = std::min(command.bounds[2], clip.x() + clip.w());
+			command.bounds[3] = std::min(command.bounds[3], clip.y() + clip.h());
+		}
+
+		return command;
+	}
+
+	void DrawList::fill(const Colour& colour)
+	{
+		this->emit(DrawCommand::FILL, colour, 0.f);
+	}
+
+	void DrawList::gradient(float sx, float sy, float ex, float ey, const Colour& first, const Colour& second)
+	{
+		State& state = d_states.back();
+		DrawCommand& command = this->emit(DrawCommand::GRADIENT, first, 0.f);
+		assignColour(command.colour2, second);
+
+		float paint[8] = { sx + state.x, sy + state.y, ex + state.x, ey + state.y, 0.f, 0.f, 0.f, 0.f };
+		memcpy(command.paint, paint, sizeof(paint));
+	}
+
+	void DrawList::stroke(float width, const Colour& colour)
+	{
+		DrawCommand& command = this->emit(DrawCommand::STROKE, colour, width * 0.5f);
+		command.paint[0] = width;
+	}
+
+	void DrawList::shadow(const BoxFloat& box, float radius, float feather, const BoxFloat& rect, const BoxFloat& hole, const BoxFloat& corners, const Colour& inner, const Colour& outer)
+	{
+		State& state = d_states.back();
+		this->pathRect(hole, corners);
+
+		float area[4] = { rect.x() + state.x, rect.y() + state.y, rect.w(), rect.h() };
+		d_path.bounds[0] = area[0];
+		d_path.bounds[1] = area[1];
+		d_path.bounds[2] = area[0] + area[2];
+		d_path.bounds[3] = area[1] + area[3];
+
+		DrawCommand& command = this->emit(DrawCommand::SHADOW, inner, 0.f);
+		assignColour(command.colour2, outer);
+		memcpy(command.outer, area, sizeof(area));
+
+		float paint[8] = { box.x() + state.x, box.y() + state.y, box.w(), box.h(), radius, feather, 0.f, 0.f };
+		memcpy(command.paint, paint, sizeof(paint));
+	}
+
+	void DrawList::image(int image, const BoxFloat& rect, const BoxFloat& pattern)
+	{
+		State& state = d_states.back();
+		this->pathRect(rect, BoxFloat());
+
+		DrawCommand& command = this->emit(DrawCommand::IMAGE, Colour::White, 0.f);
+		command.texture = image;
+
+		float paint[8] = { pattern.x() + state.x, pattern.y() + state.y, pattern.w(), pattern.h(), 0.f, 0.f, 0.f, 0.f };
+		memcpy(command.paint, paint, sizeof(paint));
+	}
+
+	void DrawList::text(float x, float y, const char* start, const char* end, const string& font, float size, Align align, const Colour& colour, const BoxFloat& bounds)
+	{
+		State& state = d_states.back();
+		this->pathRect(bounds, BoxFloat());
+
+		DrawCommand& command = this->emit(DrawCommand::TEXT, colour, 0.f);
+		command.align = uint8_t(align);
+
+		auto it = std::find(d_fonts.begin(), d_fonts.end(), font);
+		command.texture = int(it - d_fonts.begin());
+		if(it == d_fonts.end())
+			d_fonts.push_back(font);
+
+		command.text = uint32_t(d_text.size());
+		command.length = uint32_t(end - start);
+		d_text.insert(d_text.end(), start, end);
+		d_text.push_back('\0');
+
+		float paint[8] = { x + state.x, y + state.y, size, 0.f, 0.f, 0.f, 0.f, 0.f };
+		memcpy(command.paint, paint, sizeof(paint));
+	}
+
+	void DrawList::append(const DrawList& other, float x, float y, float scale, const BoxFloat& clip)
+	{
+		auto point = [x, y, scale](float* values) { values[0] = x + values[0] * scale; values[1] = y + values[1] * scale; };
+		auto size = [scale](float* values, size_t count) { for(size_t i = 0; i < count; ++i) values[i] *= scale; };
+
+		// the clips of the other list are placed and intersected with the clip it is appended within, on first use
+		d_clipRemap.assign(other.d_clips.size(), UINT32_MAX);
+
+		for(const DrawCommand& source : other.d_commands)
+		{
+			d_commands.push_back(source);
+			DrawCommand& command = d_commands.back();
+
+			if(command.shape >= DrawCommand::LINE)
+			{
+				for(size_t i = 0; i < 8; i += 2)
+					point(command.path + i);
+			}
+			else
+			{
+				point(command.path);
+				size(command.path + 2, 6);
+			}
+
+			if(command.kind == DrawCommand::GRADIENT)
+			{
+				point(command.paint);
+				point(command.paint + 2);
+			}
+			else if(command.kind == DrawCommand::SHADOW)
+			{
+				point(command.paint);
+				size(command.paint + 2, 4);
+				point(command.outer);
+				size(command.outer + 2, 2);
+			}
+			else if(command.kind == DrawCommand::IMAGE)
+			{
+				point(command.paint);
+				size(command.paint + 2, 2);
+			}
+			else if(command.kind == DrawCommand::TEXT)
+			{
+				point(command.paint);
+				size(command.paint + 2, 1);
+
+				auto it = std::find(d_fonts.begin(), d_fonts.end(), other.d_fonts[command.texture]);
+				command.texture = int(it - d_fonts.begin());
+				if(it == d_fonts.end())
+					d_fonts.push_back(other.d_fonts[source.texture]);
+
+				command.text = uint32_t(d_text.size());
+				d_text.insert(d_text.end(), other.d_text.begin() + source.text, other.d_text.begin() + source.text + source.length + 1);
+			}
+			else if(command.kind == DrawCommand::STROKE)
+			{
+				size(command.paint, 1);
+			}
+
+			point(command.bounds);
+			point(command.bounds + 2);
+
+			uint32_t& remapped = d_clipRemap[source.clip];
+			if(remapped == UINT32_MAX)
+			{
+				BoxFloat rect = clip;
+				if(source.clip)
+				{
+					const BoxFloat& own = other.d_clips[source.clip];
+					rect = BoxFloat(x + own.x() * scale, y + own.y() * scale, own.w() * scale, own.h() * scale);
+					if(!clip.null())
+					{
+						float x0 = std::max(rect.x(), clip.x());
+						float y0 = std::max(rect.y(), clip.y());
+						float x1 = std::min(rect.x() + rect.w(), clip.x() + clip.w());
+						float y1 = std::min(rect.y() + rect.h(), clip.y() + clip.h());
+						rect = BoxFloat(x0, y0, std::max(0.f, x1 - x0), std::max(0.f, y1 - y0));
+					}
+				}
+				remapped = rect.null() ? 0 : this->addClip(rect);
+			}
+
+			command.clip = remapped;
+			if(command.clip)
+			{
+				const BoxFloat& rect = d_clips[command.clip];
+				command.bounds[0] = std::max(command.bounds[0], rect.x());
+				command.bounds[1] = std::max(command.bounds[1], rect.y());
+				command.bounds[2] = std::min(command.bounds[2], rect.x() + rect.w());
+				command.bounds[3] = std::min(command.bounds[3], rect.y() + rect.h());
+			}
+		}
+	}
+
+	void DrawList::sort()
+	{
+		d_batches.clear();
+		d_order.clear();
+		d_runs.clear();
+
+		// each command joins the last batch of its state, unless a batch it overlaps was emitted since
+		std::vector<uint32_t> batchOf(d_commands.size());
+		for(size_t i = 0; i < d_commands.size(); ++i)
+		{
+			const DrawCommand& command = d_commands[i];
+			uint32_t state = command.state();
+
+			size_t target = d_batches.size();
+			size_t lookback = 0;
+			for(size_t b = d_batches.size(); b-- > 0 && lookback++ < s_lookback;)
+			{
+				Batch& batch = d_batches[b];
+				if(batch.clip == command.clip && batch.state == state)
+				{
+					target = b;
+					break;
+				}
+				if(overlaps(batch.bounds, command.bounds))
+					break;
+			}
+
+			if(target == d_batches.size())
+				d_batches.push_back({ command.clip, state, { command.bounds[0], command.bounds[1], command.bounds[2], command.bounds[3] }, 0 });
+			else
+				extend(d_batches[target].bounds, command.bounds);
+
+			++d_batches[target].count;
+			batchOf[i] = uint32_t(target);
+		}
+
+		std::vector<size_t> offsets(d_batches.size() + 1, 0);
+		for(size_t b = 0; b < d_batches.size(); ++b)
+			offsets[b + 1] = offsets[b] + d_batches[b].count;
+
+		d_order.resize(d_commands.size());
+		std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+		for(size_t i = 0; i < d_commands.size(); ++i)
+			d_order[cursors[batchOf[i]]++] = uint32_t(i);
+
+		// within a batch, consecutive solid fills and strokes of the same paint merge, unless translucent ones overlap
+		float bounds[4] = {};
+		for(size_t b = 0; b < d_batches.size(); ++b)
+			for(size_t i = offsets[b]; i < offsets[b + 1]; ++i)
+			{
+				const DrawCommand& command = d_commands[d_order[i]];
+				bool translucent = command.colour[3] < 1.f;
+
+				if(i > offsets[b] && merges(d_commands[d_order[i - 1]], command) && !(translucent && overlaps(bounds, command.bounds)))
+				{
+					d_runs.back().end = i + 1;
+					extend(bounds, command.bounds);
+					continue;
+				}
+
+				d_runs.push_back({ i, i + 1, command.clip, d_batches[b].state });
+				memcpy(bounds, command.bounds, sizeof(bounds));
+			}
+	}
+
+	size_t DrawList::emittedStateChanges()
+	{
+		size_t changes = 0;
+		for(size_t i = 0; i < d_commands.size(); ++i)
+			if(i == 0 || d_commands[i].clip != d_commands[i - 1].clip || d_commands[i].state() != d_commands[i - 1].state())
+				++changes;
+		return changes;
+	}
+
+	size_t DrawList::stateChanges()
+	{
+		size_t changes = 0;
+		for(size_t i = 0; i < d_runs.size(); ++i)
+			if(i == 0 || d_runs[i].clip != d_runs[i - 1].clip || d_runs[i].state != d_runs[i - 1].state)
+				++changes;
+		return changes;
+	}
+}
@@ -0,0 +1,162 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_DRAWLIST_H
+#define TOY_DRAWLIST_H
+
+/* toy */
+#include <toyobj/String/String.h>
+#include <toyui/Forward.h>
+#include <toyui/Style/Dim.h>
+
+/* Standards */
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace toy
+{
+	/* A single primitive, in the space of the list, tied to the clip it was emitted within */
+	struct DrawCommand
+	{
+		enum Kind : uint8_t
+		{
+			FILL,			// path filled with the first colour
+			GRADIENT,		// path filled with a linear gradient from the first colour to the second
+			STROKE,			// path stroked with the first colour
+			SHADOW,			// box gradient from the first colour to the second, around a hole
+			IMAGE,			// rect filled with an image pattern
+			TEXT			// glyph run
+		};
+
+		enum Shape : uint8_t
+		{
+			RECT,			// x, y, w, h
+			ROUNDED_RECT,	// x, y, w, h, and the four corner radii
+			LINE,			// x1, y1, x2, y2
+			BEZIER			// x1, y1, c1x, c1y, c2x, c2y, x2, y2
+		};
+
+		Kind kind;
+		Shape shape;
+		uint8_t align;
+		uint32_t clip;
+		int texture;
+
+		// geometry of the path, the hole of a shadow
+		float path[8];
+		// gradient points, image pattern, shadow box radius and feather, stroke width or text position and size
+		float paint[8];
+		float colour[4];
+		float colour2[4];
+		// outer rect of a shadow
+		float outer[4];
+
+		uint32_t text;
+		uint32_t length;
+
+		// area touched by the command, within its clip
+		float bounds[4];
+
+		// commands sharing a state are drawn with the same program and texture
+		uint32_t state() const;
+	};
+
+	/* The render pass emits the commands of the frames it paints in order, they are then sorted into batches of a single state,
+	   without moving a command across an overlapping one of another batch or out of its clip, and submitted by the backend,
+	   solid fills and strokes of the same paint being merged into a single call. */
+	class TOY_UI_EXPORT DrawList
+	{
+	public:
+		DrawList();
+
+		// consecutive commands of a batch the backend submits with a single call
+		struct Run
+		{
+			size_t begin;
+			size_t end;
+			uint32_t clip;
+			uint32_t state;
+		};
+
+		void clear();
+
+		// placement of the commands emitted, for a list spanning several frames
+		void pushState(float x, float y);
+		void resetState();
+		void popState();
+
+		void clip(const BoxFloat& rect);
+		void unclip();
+
+		// the path is kept for the fills and strokes that follow, until another one is begun
+		void pathRect(const BoxFloat& rect, const BoxFloat& corners);
+		void pathLine(float x1, float y1, float x2, float y2);
+		void pathBezier(float x1, float y1, float c1x, float c1y, float c2x, float c2y, float x2, float y2);
+
+		void fill(const Colour& colour);
+		void gradient(float sx, float sy, float ex, float ey, const Colour& first, const Colour& second);
+		void stroke(float width, const Colour& colour);
+
+		void shadow(const BoxFloat& box, float radius, float feather, const BoxFloat& rect, const BoxFloat& hole, const BoxFloat& corners, const Colour& inner, const Colour& outer);
+		void image(int image, const BoxFloat& rect, const BoxFloat& pattern);
+		void text(float x, float y, const char* start, const char* end, const string& font, float size, Align align, const Colour& colour, const BoxFloat& bounds);
+
+		// appends the commands of another list, placed at a position and scale, and clipped within a rect unless it is null
+		void append(const DrawList& other, float x, float y, float scale, const BoxFloat& clip);
+
+		void sort();
+
+		const std::vector<DrawCommand>& commands() { return d_commands; }
+		const DrawCommand& command(size_t index) { return d_commands[d_order[index]]; }
+		const std::vector<Run>& runs() { return d_runs; }
+
+		const BoxFloat& clipRect(uint32_t clip) { return d_clips[clip]; }
+		const string& font(const DrawCommand& command) { return d_fonts[command.texture]; }
+		const char* text(const DrawCommand& command) { return d_text.data() + command.text; }
+
+		// calls and state changes it takes to submit the commands in the order they were emitted, and once sorted
+		size_t emittedDrawCalls() { return d_commands.size(); }
+		size_t emittedStateChanges();
+		size_t drawCalls() { return d_runs.size(); }
+		size_t stateChanges();
+
+		static size_t s_lookback;
+
+	protected:
+		struct State
+		{
+			float x;
+			float y;
+			uint32_t clip;
+		};
+
+		struct Batch
+		{
+			uint32_t clip;
+			uint32_t state;
+			float bounds[4];
+			size_t count;
+		};
+
+		DrawCommand& emit(DrawCommand::Kind kind, const Colour& colour, float margin);
+		uint32_t addClip(const BoxFloat& clip);
+
+		std::vector<DrawCommand> d_commands;
+		std::vector<BoxFloat> d_clips;
+		std::unordered_map<size_t, uint32_t> d_clipLookup;
+		std::vector<uint32_t> d_clipRemap;
+		std::vector<string> d_fonts;
+		std::vector<char> d_text;
+		std::vector<State> d_states;
+
+		DrawCommand d_path;
+
+		std::vector<Batch> d_batches;
+		std::vector<uint32_t> d_order;
+		std::vector<Run> d_runs;
+	};
+}
+
+#endif // TOY_DRAWLIST_H
@@ -23,6 +23,7 @@ namespace toy
 			, m_resized(false)
 			, m_active(true)
 			, m_shutdown(false)
+			, m_present(true)
 		{}
 
 		virtual bool nextFrame() = 0;
@@ -40,6 +41,13 @@ namespace toy
 		bool active() { return m_active; }
 		bool shutdown() { return m_shutdown; }
 
+		// when the frame rendered nothing new, the window has nothing to present
+		bool present() { return m_present; }
+		void setPresent(bool present) { m_present = present; }
+
+		// age of the back buffer in presented frames, 0 when its content is undefined or the platform can't tell
+		virtual size_t bufferAge() { return 0; }
+
 	protected:
 		string m_title;
 		unsigned int m_width;
@@ -52,6 +60,7 @@ namespace toy
 		bool m_resized;
 		bool m_active;
 		bool m_shutdown;
+		bool m_present;
 	};
 }
 
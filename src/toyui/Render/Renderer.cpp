@@ -4,6 +4,7 @@
 
 #include <toyui/Config.h>
 #include <toyui/Render/Renderer.h>
+#include <toyui/Render/DrawList.h>
 
 #include <toyui/Frame/Frame.h>
 #include <toyui/Frame/Layer.h>
@@ -11,24 +12,131 @@
 #include <toyui/Widget/Widget.h>
 #include <toyui/UiWindow.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace toy
 {
 	RenderTarget::RenderTarget(Renderer& renderer, MasterLayer& masterLayer, bool gammaCorrected)
 		: m_renderer(renderer)
 		, m_masterLayer(masterLayer)
 		, m_gammaCorrected(gammaCorrected)
+		, m_partialRedraw(false)
+		, m_bufferAge(0)
+		, m_redrawRect()
+		, m_damageHistory()
+		, m_presented(false)
+		, m_renders(0)
+		, m_skips(0)
 	{}
 
 	void RenderTarget::render()
 	{
+		BoxFloat full(0.f, 0.f, m_masterLayer.width(), m_masterLayer.height());
+
+		if(m_partialRedraw && !m_masterLayer.damaged())
+		{
+			m_presented = false;
+			++m_skips;
+			return;
+		}
+
+		// the back buffer holds the image presented as many frames ago as its age, which is missing the damage of the frames since
+		BoxFloat current = m_masterLayer.damage();
+		bool partial = m_partialRedraw && m_bufferAge > 0 && m_bufferAge <= m_damageHistory.size() + 1;
+		if(partial)
+			for(size_t i = 0; i + 1 < m_bufferAge; ++i)
+				m_masterLayer.damage(m_damageHistory[i]);
+
+		if(!partial)
+		{
+			m_redrawRect = full;
+		}
+		else
+		{
+			// snapped outwards to whole pixels, within the target
+			const BoxFloat& region = m_masterLayer.damage();
+			float x0 = std::floor(std::max(0.f, region.x()));
+			float y0 = std::floor(std::max(0.f, region.y()));
+			float x1 = std::ceil(std::min(full.w(), region.x() + region.w()));
+			float y1 = std::ceil(std::min(full.h(), region.y() + region.h()));
+			m_redrawRect.assign(x0, y0, std::max(0.f, x1 - x0), std::max(0.f, y1 - y0));
+
+			// changes that are all off the target leave the image as it is
+			if(m_redrawRect.w() == 0.f || m_redrawRect.h() == 0.f)
+			{
+				m_masterLayer.clearDamage();
+				m_presented = false;
+				++m_skips;
+				return;
+			}
+		}
+
+		m_damageHistory.insert(m_damageHistory.begin(), current);
+		if(m_damageHistory.size() >= s_maxBufferAge)
+			m_damageHistory.pop_back();
+
 		m_renderer.render(*this);
+		m_masterLayer.clearDamage();
+		m_presented = true;
+		++m_renders;
 	}
 
 	Renderer::Renderer(const string& resourcePath)
 		: m_resourcePath(resourcePath)
 		, m_debugBatch(0)
 		, m_debugDepth(0)
+		, m_recordedSegments(0)
+		, m_reusedSegments(0)
+		, m_layerTextures(0)
+		, m_occludedLayers(0)
+		, m_visitedFrames(0)
+		, m_drawnFrames(0)
+		, m_drawCommands(0)
+		, m_drawCalls(0)
+		, m_stateChanges(0)
+		, m_unsortedDrawCalls(0)
+		, m_unsortedStateChanges(0)
 	{
 		DrawFrame::sRenderer = this;
 	}
+
+	Renderer::~Renderer()
+	{
+		if(DrawFrame::sRenderer == this)
+			DrawFrame::sRenderer = nullptr;
+	}
+
+	void Renderer::pushCull(const BoxFloat& rect)
+	{
+		if(m_culls.empty())
+		{
+			m_culls.push_back(rect);
+			return;
+		}
+
+		const BoxFloat& top = m_culls.back();
+		float x0 = std::max(top.x(), rect.x());
+		float y0 = std::max(top.y(), rect.y());
+		float x1 = std::min(top.x() + top.w(), rect.x() + rect.w());
+		float y1 = std::min(top.y() + top.h(), rect.y() + rect.h());
+		m_culls.push_back(BoxFloat(x0, y0, std::max(0.f, x1 - x0), std::max(0.f, y1 - y0)));
+	}
+
+	void Renderer::flush(DrawList& list)
+	{
+		if(list.commands().empty())
+			return;
+
+		list.sort();
+
+		m_drawCommands += list.commands().size();
+		m_drawCalls += list.drawCalls();
+		m_stateChanges += list.stateChanges();
+		m_unsortedDrawCalls += list.emittedDrawCalls();
+		m_unsortedStateChanges += list.emittedStateChanges();
+
+		this->submit(list);
+		list.clear();
+	}
 }
@@ -24,6 +24,22 @@ namespace toy
 		bool gammaCorrected() { return m_gammaCorrected; }
 		void setGammaCorrected(bool enabled) { m_gammaCorrected = enabled; }
 
+		// on targets that keep their content between frames, only the damaged area is painted again, and nothing when nothing changed
+		bool partialRedraw() { return m_partialRedraw; }
+		void setPartialRedraw(bool enabled) { m_partialRedraw = enabled; }
+
+		// age of the back buffer in presented frames as reported by the platform, 0 when its content is undefined
+		// a partial redraw repaints the damage of as many frames, and the whole target when the age is unknown
+		size_t bufferAge() { return m_bufferAge; }
+		void setBufferAge(size_t age) { m_bufferAge = age; }
+
+		// area painted by the last render, and whether it produced a new image at all
+		const BoxFloat& redrawRect() { return m_redrawRect; }
+		bool presented() { return m_presented; }
+
+		size_t renders() { return m_renders; }
+		size_t skips() { return m_skips; }
+
 		void render();
 
 	protected:
@@ -31,13 +47,23 @@ namespace toy
 		MasterLayer& m_masterLayer;
 
 		bool m_gammaCorrected;
+		bool m_partialRedraw;
+		size_t m_bufferAge;
+
+		static const size_t s_maxBufferAge = 4;
+
+		BoxFloat m_redrawRect;
+		std::vector<BoxFloat> m_damageHistory;
+		bool m_presented;
+		size_t m_renders;
+		size_t m_skips;
 	};
 
 	class TOY_UI_EXPORT Renderer
 	{
 	public:
 		Renderer(const string& resourcePath);
-		virtual ~Renderer() {}
+		virtual ~Renderer();
 
 		// init
 		virtual void setupContext() = 0;
@@ -64,6 +90,14 @@ namespace toy
 		virtual void clearLayer(void* layerCache) = 0;
 		virtual void drawLayer(void* layerCache, float x, float y, float scale = 1.f) = 0;
 
+		// each frame records its own commands into a segment, in its local space : the layer being updated appends it,
+		// and replays it wherever the frame is placed at the time, within the clip of the frames appended before it
+		virtual void segmentCache(void*& segment) = 0;
+		virtual void releaseSegment(void* segment) = 0;
+		virtual void recordSegment(void* segment) = 0;
+		virtual void endSegment() = 0;
+		virtual void appendSegment(Frame& frame, void* segment, const BoxFloat& clip) = 0;
+
 		virtual void beginUpdate(void* layerCache, float x, float y, float scale = 1.f) = 0;
 		virtual void endUpdate() = 0;
 #else
@@ -71,7 +105,6 @@ namespace toy
 		virtual void endUpdate() = 0;
 #endif
 
-		virtual bool clipTest(const BoxFloat& rect) = 0;
 		virtual void clipRect(const BoxFloat& rect) = 0;
 		virtual void unclipRect() = 0;
 
@@ -97,10 +130,56 @@ namespace toy
 		virtual float textLineHeight(InkStyle& skin) = 0;
 		virtual float textSize(const string& text, Dimension dim, InkStyle& skin) = 0;
 
+		// the primitives are emitted into a draw list, sorted by state and handed to the backend as a whole
+		virtual void submit(DrawList& list) = 0;
+		void flush(DrawList& list);
+
+		// segments recorded anew and replayed as they were by the last render
+		size_t recordedSegments() { return m_recordedSegments; }
+		size_t reusedSegments() { return m_reusedSegments; }
+
+		// layers rendered again to the texture they are composited from by the last render
+		size_t layerTextures() { return m_layerTextures; }
+
+		// layers left out by the last render, as opaque layers above them covered the area it painted
+		size_t occludedLayers() { return m_occludedLayers; }
+
+		// absolute area the traversed frames are clipped to : a frame entirely outside of it is skipped along with its subtree
+		const BoxFloat* cullRect() { return m_culls.empty() ? nullptr : &m_culls.back(); }
+		bool culled(const BoxFloat& rect) { return !m_culls.empty() && !rect.intersects(m_culls.back()); }
+		void pushCull(const BoxFloat& rect);
+		void popCull() { m_culls.pop_back(); }
+		void resetCulls() { m_culls.clear(); }
+
+		// frames the last render went through, and the ones it actually drew
+		size_t visitedFrames() { return m_visitedFrames; }
+		size_t drawnFrames() { return m_drawnFrames; }
+		void countVisit() { ++m_visitedFrames; }
+		void countDraw() { ++m_drawnFrames; }
+
+		// primitives emitted by the last render, the draw calls and state changes they took once sorted, and would have taken in emission order
+		size_t drawCommands() { return m_drawCommands; }
+		size_t drawCalls() { return m_drawCalls; }
+		size_t stateChanges() { return m_stateChanges; }
+		size_t unsortedDrawCalls() { return m_unsortedDrawCalls; }
+		size_t unsortedStateChanges() { return m_unsortedStateChanges; }
+
 	protected:
 		string m_resourcePath;
 		size_t m_debugBatch;
 		size_t m_debugDepth;
+		size_t m_recordedSegments;
+		size_t m_reusedSegments;
+		size_t m_layerTextures;
+		size_t m_occludedLayers;
+		size_t m_visitedFrames;
+		size_t m_drawnFrames;
+		size_t m_drawCommands;
+		size_t m_drawCalls;
+		size_t m_stateChanges;
+		size_t m_unsortedDrawCalls;
+		size_t m_unsortedStateChanges;
+		std::vector<BoxFloat> m_culls;
 	};
 }
 
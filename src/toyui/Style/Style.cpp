@@ -22,6 +22,22 @@ namespace toy
 			m_empty = false;
 	}
 
+	bool InkStyle::sameMetrics(const InkStyle& other) const
+	{
+		// colours, gradients, borders, corners, margins and shadows only affect painting
+		for(size_t i = 0; i < 4; ++i)
+			if(m_padding.val[i] != other.m_padding.val[i])
+				return false;
+
+		return m_textFont.val == other.m_textFont.val
+			&& m_textSize.val == other.m_textSize.val
+			&& m_textBreak.val == other.m_textBreak.val
+			&& m_textWrap.val == other.m_textWrap.val
+			&& m_image.val == other.m_image.val
+			&& m_imageSkin.val.d_image == other.m_imageSkin.val.d_image
+			&& m_imageSkin.val.d_stretch == other.m_imageSkin.val.d_stretch;
+	}
+
 	Style::Style(Type& type, Style* base)
 		: Object()
 		, m_styleType(&type)
@@ -227,6 +227,9 @@ namespace toy
 
 		void prepare();
 
+		// true when switching between the two skins doesn't affect the frame metrics
+		bool sameMetrics(const InkStyle& other) const;
+
 		Style* m_style;
 		StyleAttr<bool> m_empty;
 		StyleAttr<Style*> m_base;
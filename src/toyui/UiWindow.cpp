@@ -16,9 +16,13 @@
 
 #include <toyui/Frame/Frame.h>
 #include <toyui/Frame/Stripe.h>
+#include <toyui/Frame/Layer.h>
 
 #include <toyui/Controller/Controller.h>
 
+#include <toyui/Input/InputDispatcher.h>
+#include <toyui/Input/InputRecorder.h>
+
 #include <stb_image.h>
 #include <dirent.h>
 
@@ -84,13 +88,18 @@ namespace toy
 		, m_styler(make_unique<Styler>(*this))
 		, m_rootSheet(nullptr)
 		, m_shutdownRequested(false)
+		, m_tick(0)
+		, m_timings()
 		, m_user(user)
 	{
+		InputLatency::s_tracker = &m_latency;
 		this->init();
 	}
 
 	UiWindow::~UiWindow()
 	{
+		this->stopRecording();
+
 		for(Image& image : m_images)
 			m_renderer->unloadImage(image);
 
@@ -185,23 +194,80 @@ namespace toy
 		|| m_context->renderWindow().height() != size_t(m_height))
 			this->resize(m_context->renderWindow().width(), m_context->renderWindow().height());
 
+		PhaseTimer timer;
+
+		// input is drained as the frame starts, so that it is laid out and rendered within the same frame
+		m_context->inputWindow().nextFrame();
+		m_timings.input = timer.lap();
+
+		size_t delta = 0;
+		if(m_frameClock)
+		{
+			delta = m_frameClock();
+			m_tick += delta;
+		}
+		else
+		{
+			m_tick = m_clock.readTick();
+			delta = m_clock.stepTick();
+		}
+
+		if(m_recorder)
+			m_recorder->frame(delta);
+
+		m_rootSheet->nextFrame(m_tick, delta);
+		timer.lap();
+
+		// the cursor is sampled again right before rendering, so that drags follow its freshest position
+		if(m_context->inputWindow().latchCursor(m_rootSheet->mouse()))
+		{
+			MasterLayer& layer = m_rootSheet->frame().as<MasterLayer>();
+			layer.relayout();
+			layer.redraw();
+			m_timings.input += timer.lap();
+		}
+
+		bool presented = true;
 		if(m_context->renderSystem().manualRender())
 		{
+			m_rootSheet->target().setBufferAge(m_context->renderWindow().bufferAge());
 			m_rootSheet->target().render();
+			presented = m_rootSheet->target().presented();
+			m_context->renderWindow().setPresent(presented);
 			// add sub layers
 		}
 
 		m_context->renderWindow().nextFrame();
-		m_context->inputWindow().nextFrame();
-
-		size_t tick = m_clock.readTick();
-		size_t delta = m_clock.stepTick();
+		m_timings.render = timer.lap();
 
-		m_rootSheet->nextFrame(tick, delta);
+		// a frame skipped without damage shows nothing new : the events stay pending until a frame reaches the screen
+		if(presented)
+			m_latency.present(inputTime());
 
 		return !m_shutdownRequested;
 	}
 
+	void UiWindow::startRecording(const string& path)
+	{
+		m_recorder = make_unique<InputRecorder>(path);
+		if(!m_recorder->open())
+		{
+			printf("ERROR: could not open %s to record input\n", path.c_str());
+			m_recorder = nullptr;
+			return;
+		}
+		m_context->inputWindow().setRecorder(m_recorder.get());
+	}
+
+	void UiWindow::stopRecording()
+	{
+		if(!m_recorder)
+			return;
+
+		m_context->inputWindow().setRecorder(nullptr);
+		m_recorder = nullptr;
+	}
+
 	void UiWindow::shutdown()
 	{
 		m_shutdownRequested = true;
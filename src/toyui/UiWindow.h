@@ -12,11 +12,36 @@
 //#include <toyui/Device/RootDevice.h>
 #include <toyui/Render/RenderWindow.h>
 #include <toyui/ImageAtlas.h>
+#include <toyui/Input/InputLatency.h>
 
 #include <vector>
+#include <functional>
+#include <chrono>
 
 namespace toy
 {
+	// milliseconds spent in each phase of a frame
+	struct TOY_UI_EXPORT FrameTimings
+	{
+		double input;
+		double layout;
+		double redraw;
+		double update;
+		double render;
+	};
+
+	class TOY_UI_EXPORT PhaseTimer
+	{
+	public:
+		PhaseTimer() : m_start(std::chrono::steady_clock::now()) {}
+
+		// milliseconds since the last lap
+		double lap() { auto now = std::chrono::steady_clock::now(); double elapsed = std::chrono::duration<double, std::milli>(now - m_start).count(); m_start = now; return elapsed; }
+
+	protected:
+		std::chrono::steady_clock::time_point m_start;
+	};
+
 	class TOY_UI_EXPORT RenderSystem
 	{
 	public:
@@ -83,6 +108,16 @@ namespace toy
 		
 		User& user() const { return *m_user; }
 
+		FrameTimings& timings() { return m_timings; }
+		InputLatency& latency() { return m_latency; }
+
+		// the frame clock returns the ticks elapsed since the previous frame, in place of the wall clock
+		typedef std::function<size_t()> FrameClock;
+		void setFrameClock(const FrameClock& clock) { m_frameClock = clock; }
+
+		void startRecording(const string& path);
+		void stopRecording();
+
 		void init();
 
 		void resize(size_t width, size_t height);
@@ -124,6 +159,12 @@ namespace toy
 		bool m_shutdownRequested;
 
 		Clock m_clock;
+		FrameClock m_frameClock;
+		size_t m_tick;
+
+		unique_ptr<InputRecorder> m_recorder;
+		FrameTimings m_timings;
+		InputLatency m_latency;
 
 		User* m_user;
 	};
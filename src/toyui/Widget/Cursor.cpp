@@ -19,7 +19,7 @@ namespace toy
 		: Decal(rootSheet, cls())
 		, m_tooltip(rootSheet, "")
 	{
-		m_hovered = &rootSheet;
+		m_hovered = rootSheet.handle();
 
 		this->tooltipOff();
 	}
@@ -28,13 +28,13 @@ namespace toy
 	{
 		Wedge::nextFrame(tick, delta);
 
-		if(m_tooltipClock.read() > 0.5f && m_tooltip.frame().hidden() && !m_hovered->tooltip().empty())
+		if(m_tooltipClock.read() > 0.5f && m_tooltip.frame().hidden() && !this->hovered().tooltip().empty())
 			this->tooltipOn();
 	}
 
 	void Cursor::setPosition(float x, float y)
 	{
-		if(!m_hovered->frame().inside(x, y))
+		if(!this->hovered().frame().inside(x, y))
 			this->unhover();
 
 		if(!m_tooltip.frame().hidden())
@@ -45,7 +45,7 @@ namespace toy
 
 	void Cursor::tooltipOn()
 	{
-		m_tooltip.setLabel(m_hovered->tooltip());
+		m_tooltip.setLabel(this->hovered().tooltip());
 		m_tooltip.frame().setPosition(m_frame->dposition(DIM_X), m_frame->dposition(DIM_Y) + m_frame->dsize(DIM_Y));
 		m_tooltip.show();
 	}
@@ -58,21 +58,21 @@ namespace toy
 
 	void Cursor::hover(Widget& widget)
 	{
-		m_hovered = &widget;
+		m_hovered = widget.handle();
 		if(widget.style().skin().hoverCursor())
 			this->setStyle(*widget.style().skin().hoverCursor(), false);
 	}
 
-	void Cursor::unhover(Widget& widget)
+	void Cursor::unhover()
 	{
-		if(m_hovered == &widget)
-			this->unhover();
+		this->setStyle(Cursor::cls(), false);
+		m_hovered = this->rootSheet().handle();
 	}
 
-	void Cursor::unhover()
+	Widget& Cursor::hovered()
 	{
-		this->setStyle(Cursor::cls(), false);
-		m_hovered = &this->rootSheet();
+		InputReceiver* hovered = m_hovered.live();
+		return hovered ? static_cast<Widget&>(*hovered) : this->rootSheet();
 	}
 
 	Tooltip::Tooltip(RootSheet& rootSheet, const string& label)
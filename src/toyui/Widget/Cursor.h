@@ -40,9 +40,11 @@ namespace toy
 		void setPosition(float x, float y);
 
 		void hover(Widget& hovered);
-		void unhover(Widget& widget);
 		void unhover();
 
+		// the hovered widget, or the root sheet once it is destroyed or detached
+		Widget& hovered();
+
 		void tooltipOn();
 		void tooltipOff();
 
@@ -50,7 +52,7 @@ namespace toy
 
 	protected:
 		bool m_dirty;
-		Widget* m_hovered;
+		ReceiverHandle m_hovered;
 		Tooltip m_tooltip;
 		Clock m_tooltipClock;
 	};
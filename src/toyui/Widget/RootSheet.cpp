@@ -54,25 +54,19 @@ namespace toy
 
 	void RootSheet::nextFrame(size_t tick, size_t delta)
 	{
+		FrameTimings& timings = m_window.timings();
+		PhaseTimer timer;
+
 		m_frame->as<MasterLayer>().relayout();
+		timings.layout = timer.lap();
+
 		m_frame->as<MasterLayer>().redraw();
+		timings.redraw = timer.lap();
 
 		m_mouse->nextFrame();
 		m_keyboard->nextFrame();
 
 		Wedge::nextFrame(tick, delta);
-	}
-
-	void RootSheet::handleUnbindWidget(Widget& widget)
-	{
-		m_rootController->yieldControl(widget);
-
-		m_cursor.unhover(widget);
-		m_mouse->handleUnbindWidget(widget);
-	}
-
-	void RootSheet::handleBindWidget(Widget& widget)
-	{
-		m_mouse->handleBindWidget(widget);
+		timings.update = timer.lap();
 	}
 }
@@ -38,9 +38,6 @@ namespace toy
 
 		virtual InputReceiver* propagateEvent(InputEvent& inputEvent) { return nullptr; }
 
-		virtual void handleUnbindWidget(Widget& widget);
-		virtual void handleBindWidget(Widget& widget);
-
 		static Type& cls() { static Type ty("RootSheet", Container::cls()); return ty; }
 
 	protected:
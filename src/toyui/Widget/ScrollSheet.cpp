@@ -98,7 +98,7 @@ namespace toy
 
 	void ScrollPlan::nextFrame(size_t tick, size_t delta)
 	{
-		bool dirty = m_surface.frame().dirty();
+		bool dirty = m_surface.frame().subtreeDirty() > Frame::CLEAN;
 		if(dirty)
 			this->updateBounds();
 
@@ -125,7 +125,6 @@ namespace toy
 	void ScrollPlan::middleDrag(MouseEvent& mouseEvent)
 	{
 		m_plan.frame().setPosition(std::min(0.f, m_plan.frame().dposition(DIM_X) + mouseEvent.deltaX), std::min(0.f, m_plan.frame().dposition(DIM_Y) + mouseEvent.deltaY));
-		m_plan.frame().layer().setForceRedraw();
 	}
 
 	void ScrollPlan::mouseWheel(MouseEvent& mouseEvent)
@@ -141,7 +140,7 @@ namespace toy
 		}
 
 		m_plan.frame().setScale(scale);
-		m_plan.frame().layer().setForceRedraw();
+		m_plan.frame().markDirty(Frame::DIRTY_ABSOLUTE);
 
 		DimFloat absolute = m_plan.frame().absolutePosition();
 		float distanceX = mouseEvent.posX - absolute[DIM_X];
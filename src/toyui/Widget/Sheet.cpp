@@ -12,6 +12,9 @@
 
 #include <toyui/Widget/Layout.h>
 
+#include <toyui/Render/Renderer.h>
+#include <toyui/Render/DrawFrame.h>
+
 #include <toyui/Button/Scrollbar.h>
 #include <toyui/Widget/RootSheet.h>
 
@@ -42,14 +45,74 @@ namespace toy
 		if(m_frame->layer().forceRedraw())
 			force = true;
 
-		m_frame->content().beginDraw(renderer, force);
-		m_frame->content().draw(renderer, force);
+		DrawFrame& content = m_frame->content();
+		content.beginDraw(renderer, force);
+		content.draw(renderer, force);
+
+		bool culled = false;
+		bool subtreeCulled = false;
+
+		auto renderContent = [&](Widget& widget) {
+			Frame& frame = widget.frame();
+			if(frame.hidden())
+				return;
+#ifdef TOYUI_DRAW_CACHE
+			// sublayers are updated by the renderer on their own
+			if(frame.frameType() == LAYER)
+				return;
+#endif
+			renderer.countVisit();
+			if(renderer.culled(frame.absoluteRect()))
+			{
+				culled = true;
+				return;
+			}
 
-		for(size_t i = 0; i < m_contents.size(); ++i)
-			if(!m_contents[i]->frame().hidden())
-				m_contents[i]->render(renderer, force);
+			widget.render(renderer, force);
+			subtreeCulled |= frame.content().culled();
+		};
+
+		size_t first = 0;
+		size_t last = 0;
+		if(this->cullRange(renderer, first, last))
+		{
+			// a stripe maps each content at its index : only the part of the sequence within the clip is gone through
+			Stripe& stripe = m_frame->as<Stripe>();
+			const std::vector<size_t>& shown = stripe.shown();
+			culled = first > 0 || last < stripe.sequence().size();
+
+			for(size_t i = first; i < last; ++i)
+				renderContent(*m_contents[shown[i]]);
+			for(size_t i = stripe.sequence().size(); i < m_contents.size(); ++i)
+				renderContent(*m_contents[i]);
+		}
+		else
+		{
+			for(Widget* widget : m_contents)
+				renderContent(*widget);
+		}
+
+		content.setCulled(culled, subtreeCulled);
+		content.endDraw(renderer);
+	}
+
+	bool Wedge::cullRange(Renderer& renderer, size_t& first, size_t& last)
+	{
+		if(!renderer.cullRect() || (m_frame->frameType() != STRIPE && m_frame->frameType() != LAYER))
+			return false;
+
+		Stripe& stripe = m_frame->as<Stripe>();
+		if(stripe.contents().size() != m_contents.size())
+			return false;
+
+		Dimension length = stripe.length();
+		const BoxFloat& cull = *renderer.cullRect();
+		float origin = m_frame->absolutePosition()[length];
+		float scale = m_frame->absoluteScale();
 
-		m_frame->content().endDraw(renderer);
+		float start = (cull[length] - origin) / scale;
+		float end = start + cull[length + 2] / scale;
+		return stripe.shownRange(start, end, first, last);
 	}
 
 	void Wedge::visit(const Visitor& visitor)
@@ -89,19 +152,80 @@ namespace toy
 		this->reindex(index);
 	}
 
+	void Wedge::push(const std::vector<Widget*>& widgets)
+	{
+		this->insert(widgets, m_contents.size());
+	}
+
+	void Wedge::insert(const std::vector<Widget*>& widgets, size_t index)
+	{
+		this->stripe().resetMapping();
+
+		m_contents.insert(m_contents.begin() + index, widgets.begin(), widgets.end());
+		this->reindex(index);
+
+		for(Widget* widget : widgets)
+			widget->bind(*this, widget->index(), true);
+	}
+
+	void Wedge::remove(const std::vector<Widget*>& widgets)
+	{
+		if(widgets.empty())
+			return;
+
+		this->stripe().resetMapping();
+
+		size_t from = m_contents.size();
+		for(Widget* widget : widgets)
+		{
+			from = std::min(from, widget->index());
+			widget->unbind();
+		}
+
+		// unbound widgets have no parent anymore, they are all erased in one pass
+		auto unbound = [](Widget* widget) { return widget->parent() == nullptr; };
+		m_contents.erase(std::remove_if(m_contents.begin() + from, m_contents.end(), unbound), m_contents.end());
+		this->reindex(from);
+	}
+
+	void Wedge::remove(size_t first, size_t count)
+	{
+		this->remove(std::vector<Widget*>(m_contents.begin() + first, m_contents.begin() + first + count));
+	}
+
+	void Wedge::clear()
+	{
+		this->remove(0, m_contents.size());
+	}
+
+	void Wedge::reorder(const std::vector<size_t>& permutation)
+	{
+		std::vector<Widget*> contents;
+		contents.reserve(permutation.size());
+		for(size_t index : permutation)
+			contents.push_back(m_contents[index]);
+
+		this->stripe().resetMapping();
+
+		std::swap(m_contents, contents);
+		this->reindex(0);
+	}
+
 	void Wedge::move(size_t from, size_t to)
 	{
-		m_contents.insert(m_contents.begin() + to, m_contents[from]);
-		m_contents.erase(m_contents.begin() + from + 1);
+		Widget* widget = m_contents[from];
+		m_contents.erase(m_contents.begin() + from);
+		m_contents.insert(m_contents.begin() + to, widget);
 		this->reindex(from < to ? from : to);
-		m_frame->markDirty(Frame::DIRTY_MAPPING);
+		this->stripe().markRemap(widget->frame());
 	}
 
 	void Wedge::swap(size_t from, size_t to)
 	{
 		std::iter_swap(m_contents.begin() + from, m_contents.begin() + to);
 		this->reindex(from < to ? from : to);
-		m_frame->markDirty(Frame::DIRTY_MAPPING);
+		this->stripe().markRemap(m_contents[from]->frame());
+		this->stripe().markRemap(m_contents[to]->frame());
 	}
 
 	Container::Container(Wedge& parent, Type& type, FrameType frameType)
@@ -132,22 +256,123 @@ namespace toy
 
 	unique_ptr<Widget> Container::release(Widget& widget)
 	{
+		// contents of the target wedge usually share the container indices
+		size_t hint = widget.index();
 		widget.parent()->remove(widget);
-		auto pos = std::find_if(m_containerContents.begin(), m_containerContents.end(), [&widget](auto& pt) { return pt.get() == &widget; });
+
+		auto pos = m_containerContents.end();
+		if(hint < m_containerContents.size() && m_containerContents[hint].get() == &widget)
+			pos = m_containerContents.begin() + hint;
+		else
+			pos = std::find_if(m_containerContents.begin(), m_containerContents.end(), [&widget](auto& pt) { return pt.get() == &widget; });
+
 		unique_ptr<Widget> pointer = std::move(*pos);
 		m_containerContents.erase(pos);
 		this->handleRemove(widget);
 		return pointer;
 	}
 
-	void Container::clear()
+	void Container::insert(std::vector<unique_ptr<Widget>> widgets, size_t index)
+	{
+		std::vector<Widget*> unbound;
+		for(auto& widget : widgets)
+			if(widget->parent() == nullptr)
+				unbound.push_back(widget.get());
+
+		m_containerTarget->as<Wedge>().insert(unbound, index);
+
+		for(auto& widget : widgets)
+			widget->setContainer(*this);
+
+		m_containerContents.insert(m_containerContents.begin() + index, std::make_move_iterator(widgets.begin()), std::make_move_iterator(widgets.end()));
+
+		for(size_t i = index; i < index + widgets.size(); ++i)
+			this->handleAdd(*m_containerContents[i]);
+	}
+
+	void Container::append(std::vector<unique_ptr<Widget>> widgets)
+	{
+		this->insert(std::move(widgets), m_containerContents.size());
+	}
+
+	std::vector<unique_ptr<Widget>> Container::release(size_t first, size_t count)
+	{
+		auto begin = m_containerContents.begin() + first;
+		auto end = begin + count;
+
+		this->removeFromParents(begin, end);
+
+		std::vector<unique_ptr<Widget>> released(std::make_move_iterator(begin), std::make_move_iterator(end));
+		m_containerContents.erase(begin, end);
+
+		for(auto& widget : released)
+			this->handleRemove(*widget);
+
+		return released;
+	}
+
+	void Container::replace(std::vector<unique_ptr<Widget>> widgets)
 	{
-		for(auto& widget : m_containerContents)
-			widget->parent()->remove(*widget);
+		this->clear();
+		this->append(std::move(widgets));
+	}
+
+	void Container::reorder(const std::vector<size_t>& permutation)
+	{
+		std::vector<unique_ptr<Widget>> contents;
+		contents.reserve(permutation.size());
+		for(size_t index : permutation)
+			contents.push_back(std::move(m_containerContents[index]));
+
+		std::swap(m_containerContents, contents);
+
+		// the target wedge might hold other widgets : ours are permuted within the slots they already occupy
+		Wedge& target = m_containerTarget->as<Wedge>();
+		std::vector<size_t> order(target.count());
+		auto next = m_containerContents.begin();
+		for(size_t i = 0; i < order.size(); ++i)
+		{
+			Widget& widget = target.at(i);
+			if(widget.container() != this)
+			{
+				order[i] = i;
+				continue;
+			}
 
+			while((*next)->parent() != &target)
+				++next;
+			order[i] = (*next++)->index();
+		}
+
+		target.reorder(order);
+	}
+
+	void Container::clear()
+	{
+		this->removeFromParents(m_containerContents.begin(), m_containerContents.end());
 		m_containerContents.clear();
 	}
 
+	void Container::removeFromParents(std::vector<unique_ptr<Widget>>::iterator begin, std::vector<unique_ptr<Widget>>::iterator end)
+	{
+		// widgets are grouped by parent so that each parent is emptied in a single batch
+		std::vector<Widget*> widgets;
+		for(auto it = begin; it != end; ++it)
+			if((*it)->parent())
+				widgets.push_back(it->get());
+
+		auto byParent = [](Widget* a, Widget* b) { return a->parent() < b->parent(); };
+		std::stable_sort(widgets.begin(), widgets.end(), byParent);
+
+		for(auto first = widgets.begin(); first != widgets.end();)
+		{
+			Wedge* parent = (*first)->parent();
+			auto last = std::find_if(first, widgets.end(), [parent](Widget* widget) { return widget->parent() != parent; });
+			parent->remove(std::vector<Widget*>(first, last));
+			first = last;
+		}
+	}
+
 	WrapControl::WrapControl(Wedge& parent, Type& type)
 		: Container(parent, type)
 	{}
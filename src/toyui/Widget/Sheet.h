@@ -35,13 +35,22 @@ namespace toy
 		void insert(Widget& widget, size_t index, bool deferred = true);
 		void remove(Widget& widget);
 
+		void push(const std::vector<Widget*>& widgets);
+		void insert(const std::vector<Widget*>& widgets, size_t index);
+		void remove(const std::vector<Widget*>& widgets);
+		void remove(size_t first, size_t count);
+		void clear();
+
 		void reindex(size_t from);
 		void move(size_t from, size_t to);
 		void swap(size_t from, size_t to);
+		void reorder(const std::vector<size_t>& permutation);
 
 		static Type& cls() { static Type ty("Wedge", Widget::cls()); return ty; }
 
 	protected:
+		bool cullRange(Renderer& renderer, size_t& first, size_t& last);
+
 		std::vector<Widget*> m_contents;
 	};
 
@@ -66,6 +75,12 @@ namespace toy
 
 		virtual Widget& insert(unique_ptr<Widget> widget) { return this->append(std::move(widget)); }
 
+		void insert(std::vector<unique_ptr<Widget>> widgets, size_t index);
+		void append(std::vector<unique_ptr<Widget>> widgets);
+		std::vector<unique_ptr<Widget>> release(size_t first, size_t count);
+		void replace(std::vector<unique_ptr<Widget>> widgets);
+		void reorder(const std::vector<size_t>& permutation);
+
 		void clear();
 
 		template <class T, class... Args>
@@ -83,6 +98,8 @@ namespace toy
 		static Type& cls() { static Type ty("Container", Wedge::cls()); return ty; }
 
 	protected:
+		void removeFromParents(std::vector<unique_ptr<Widget>>::iterator begin, std::vector<unique_ptr<Widget>>::iterator end);
+
 		Container* m_containerTarget;
 		std::vector<unique_ptr<Widget>> m_containerContents;
 	};
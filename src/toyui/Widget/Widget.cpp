@@ -16,6 +16,8 @@
 #include <toyui/UiLayout.h>
 #include <toyui/UiWindow.h>
 
+#include <toyui/Input/InputLatency.h>
+
 #include <toyobj/Iterable/Reverse.h>
 
 namespace toy
@@ -118,24 +120,24 @@ namespace toy
 		m_index = index;
 		
 		if(deferred)
-			m_parent->frame().markDirty(Frame::DIRTY_MAPPING);
+			m_parent->stripe().markRemap(*m_frame);
 		else
 			m_parent->stripe().map(*m_frame);
 
-		RootSheet& rootSheet = this->rootSheet();
-		this->visit([&rootSheet](Widget& widget) { rootSheet.handleBindWidget(widget); return true; });
+		InputReceiver::invalidateAttachment();
 	}
 
+	// input devices and the control graph hold handles, they skip the widgets of a detached subtree when they next use them
 	void Widget::unbind()
 	{
-		RootSheet& rootSheet = this->rootSheet();
-		this->visit([&rootSheet](Widget& widget) { rootSheet.handleUnbindWidget(widget); return true; });
-
+		m_parent->stripe().unmarkRemap(*m_frame);
 		if(m_frame->mapped())
 			m_parent->stripe().unmap(*m_frame);
 
 		m_parent = nullptr;
 		m_index = 0;
+
+		InputReceiver::invalidateAttachment();
 	}
 
 	unique_ptr<Widget> Widget::extract()
@@ -216,7 +218,7 @@ namespace toy
 	
 	void Widget::markDirty()
 	{
-		m_frame->setDirty(Frame::DIRTY_CONTENT);
+		m_frame->markDirty(Frame::DIRTY_CONTENT);
 	}
 
 	void Widget::toggleState(WidgetState state)
@@ -240,7 +242,7 @@ namespace toy
 	void Widget::updateState()
 	{
 		m_frame->content().updateInkstyle(m_style->subskin(m_state));
-		m_frame->setDirty(Frame::DIRTY_CONTENT);
+		m_frame->markDirty(Frame::DIRTY_PAINT);
 	}
 	
 	Widget* Widget::pinpoint(float x, float y)
@@ -250,7 +252,7 @@ namespace toy
 
 	Widget* Widget::pinpoint(float x, float y, const Frame::Filter& filter)
 	{
-		if(m_frame->dirty() >= Frame::DIRTY_MAPPING)
+		if(m_frame->subtreeDirty() >= Frame::DIRTY_MAPPING)
 			return nullptr;
 		DimFloat absolute = m_frame->absolutePosition();
 		Frame* frame = m_frame->pinpoint(x - absolute[DIM_X], y - absolute[DIM_Y], filter);
@@ -272,6 +274,14 @@ namespace toy
 		return this;
 	}
 
+	bool Widget::attached()
+	{
+		Widget* widget = this;
+		while(widget->m_parent)
+			widget = widget->m_parent;
+		return widget->frame().frameType() >= MASTER_LAYER;
+	}
+
 	InputReceiver* Widget::propagateEvent(InputEvent& inputEvent)
 	{
 		UNUSED(inputEvent);
@@ -283,7 +293,10 @@ namespace toy
 		if(inputEvent.consumed)
 			return this;
 
-		inputEvent.visited.push_back(this);
+		if(inputEvent.visited)
+			inputEvent.visited->push_back(this);
+
+		InputLatency::Scope latency(inputEvent, *this);
 
 		if(inputEvent.deviceType >= DEVICE_MOUSE)
 		{
@@ -126,6 +126,8 @@ namespace toy
 
 		virtual bool customDraw(Renderer& renderer) { UNUSED(renderer); return false; }
 
+		virtual bool attached();
+
 		virtual InputReceiver* controlEvent(InputEvent& inputEvent);
 		virtual InputReceiver* receiveEvent(InputEvent& inputEvent);
 		virtual InputReceiver* propagateEvent(InputEvent& inputEvent);
@@ -182,7 +182,7 @@ namespace toy
 	void NodeCable::nextFrame(size_t tick, size_t delta)
 	{
 		if(m_plugOut.frame().layer().redraw() || m_plugIn.frame().layer().redraw())
-			m_frame->setDirty(Frame::DIRTY_POSITION);
+			m_frame->markDirty(Frame::DIRTY_POSITION);
 
 		Widget::nextFrame(tick, delta);
 	}